@@ -10,14 +10,22 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <stdio.h>
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef PARALLEL_STL
+#include <execution>    //parallel sort of the samples -> link with -ltbb
+#endif
 
 #include "user.cpp"
 #include "base_station.cpp"
 #include "message.cpp"
+#include "rng.cpp"
 
 double LIGHT_SPEED_FREE = 3e8;
 double LIGHT_SPEED_WIRE = 2e8;
@@ -38,13 +46,14 @@ class Utility{
         double compute_distance(auto* from, auto* to);  //compute the distance between from and to 
         void ue_set_connected(user* ue, vector <base_station*> bs, int n_bs);  //set to which BS the UE gets connected for simulation initialization
         void ue_set_AMF(user* ue, vector <base_station*> bs, int n_bs); //set the AMF for the UE 
-        void transmit_beacons(double channel[][2], int n_bs, user* ue, vector <base_station*> bs);   //fulfill the channel with the trabnsmitted signals
+        void transmit_beacons(double channel[][2], double distance[], int n_bs, user* ue, vector <base_station*> bs);   //fulfill the channel with the trabnsmitted signals
         double compute_delay(user* ue, base_station* bs, int transmission_channel);   //compute the transmission delay between ue and bs
         int random_selection(int min, int max); //return an integer random number within min and max
-        void group(vector <float> a, vector <stat_t>* b);
+        void group(vector <float>* a, vector <stat_t>* b);
         void occurences_to_probability(vector <stat_t>* b);
         float expected_value(vector <stat_t>* b);
         void sort(vector <stat_t>* b);
+        double median(vector <stat_t>* b, int n_samples);
 };
 
 
@@ -107,12 +116,13 @@ void ue_set_AMF(user* ue, vector <base_station*> bs, int n_bs){
 }
 
 /**
- * Fulfill the channel with the power signal received by the user
+ * Fulfill the channel with the power signal received by the user, and @distance with the UE-BS distances
  */
-void transmit_beacons(double channel[][2], int n_bs, user* ue, vector <base_station*> bs){
+void transmit_beacons(double channel[][2], double distance[], int n_bs, user* ue, vector <base_station*> bs){
     
     for(int i=0; i<n_bs; ++i){  
-        channel[i][0]= bs[i]->get_power() / pow(compute_distance(ue, bs[i]), 2);
+        distance[i]= compute_distance(ue, bs[i]);
+        channel[i][0]= bs[i]->get_power() / pow(distance[i], 2);
         channel[i][1]= bs[i]->get_id();
     }
 }
@@ -128,28 +138,31 @@ double compute_delay(auto from, auto to, int transmission_channel){
 int random_selection(int min, int max){
     
     if(min<0)   min=0;
-    return min + ( rand() % (max-min));
+    return min + ( sim_rand() % (max-min));
 }
 
-void group(vector <float> a, vector <stat_t>* b){
-    
-    for(int i=0; i< a.size(); ++i){ //scan all element of vector a
-
-        int j=0;
-        for(j; j<b->size(); ++j){  //scan all elements of vector b
-            if(a[i]== ((*b)[j]).value){
-                ((*b)[j]).occurences++;  //if already stored the value, then just need to increase the occurrence value
-                break;
-            }
-        }
-        
-        if(j==b->size()){    //if scanned all the elements but not found, then need to add
-            stat_t temp;
-            temp.value= a[i];
-            temp.occurences= 1;
+/**
+ * Group the values of @a in @b with their occurrences, in increasing order of value.
+ * @a is sorted in place, then equal values are consecutive -> run-length encoding
+*/
+void group(vector <float>* a, vector <stat_t>* b){
 
-            b->push_back(temp);
-        }
+#ifdef PARALLEL_STL
+    std::sort(execution::par_unseq, a->begin(), a->end());
+#else
+    std::sort(a->begin(), a->end());
+#endif
+
+    for(int i=0; i<(int) a->size(); ){
+        int j= i+1;
+        while(j < (int) a->size() && (*a)[j] == (*a)[i])  j++;    //end of the run of equal values
+
+        stat_t temp;
+        temp.value= (*a)[i];
+        temp.occurences= j-i;
+        b->push_back(temp);
+
+        i= j;
     }
 }
 
@@ -168,25 +181,41 @@ float expected_value(vector <stat_t>* b){
     return expected;
 }
 
+/**
+ * Sort in place the grouped values of @b in increasing order of value
+*/
 void sort(vector <stat_t>* b){
-    vector <stat_t> a;
 
-    while(b->size() > 0){
-        int min_pos= 0;
-        float min_value= ((*b)[0]).value;
+    std::stable_sort(b->begin(), b->end(), [](const stat_t& x, const stat_t& y){return x.value < y.value;});
+}
 
-        for(int i=1; i< b->size(); ++i){
-            if(min_value > ((*b)[i]).value){
-                min_pos = i;
-                min_value = ((*b)[i]).value;
-            }
-        }
+/**
+ * Return the median value of the grouped and sorted values in @b, which count @n_samples samples overall
+*/
+double median(vector <stat_t>* b, int n_samples){
+
+    int mediumVal= (n_samples-1)/2; //0-based index of the median sample
 
-        a.push_back((*b)[min_pos]);
-        b->erase(b->begin()+min_pos);
+    int count= 0;
+    for(int i=0; i<(int) b->size(); ++i){
+        if(count + ((*b)[i]).occurences > mediumVal)    return ((*b)[i]).value; //the group holds the samples count ... count+occurences-1
+        count+= ((*b)[i]).occurences;
     }
 
-    for(int i=0; i< a.size(); ++i)  b->push_back(a[i]);
+    return 0.0;
+}
+
+/**
+ * Group, sort and write in @write the values of a scenario. Return its median value.
+ * The values in @overall_time are sorted in place.
+*/
+double write_results(FILE* write, vector <float>* overall_time, int n_samples){
+
+    vector <stat_t> statistic;
+    group(overall_time, &statistic);    //group, in increasing order of value
+    for(int i=0; i<(int) statistic.size(); ++i)  fprintf(write, "%.9f;%d\n", statistic[i].value, statistic[i].occurences);
+
+    return median(&statistic, n_samples);
 }
 
 
@@ -0,0 +1,341 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the optional allocation tracker. It is compiled in only with -DALLOC_TRACKING:
+            g++ -std=gnu++20 -O2 -DALLOC_TRACKING main.cpp -o baron -lpthread
+        and enabled at run time with --alloc.
+        malloc, calloc, realloc, free and the aligned allocations (memalign, aligned_alloc, posix_memalign, valloc,
+        pvalloc) are interposed (operator new and delete of libstdc++ reach them as well): each block carries a
+        32-byte header with its size, its offset in the allocation of the C library and the step that allocated it,
+        so that a free is credited to the allocating step even when it happens later or in another thread.
+        The steps are the keys of the step profile (entity kind, message type, handover variant) plus, for each
+        variant, the rest of the round (topology creation, Measurement Report, deletion of the entities).
+        The report gives the allocations and bytes per handling of each step, the blocks still live at the end of
+        the run by allocating step (leaks) and, per round, the blocks and bytes not freed when the round returns.
+*/
+
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <mutex>
+
+#include "profile.cpp"
+
+using namespace std;
+
+const int ALLOC_N_KEYS= PROFILE_N_KEYS + PROFILE_N_VARIANTS;   //steps + rest of the round of each variant
+
+typedef struct{
+
+    long long handlings;    //handle_message executions of the step
+    long long allocs;
+    long long bytes;
+    long long frees;    //blocks allocated by the step and freed
+    long long freed_bytes;
+
+}alloc_stat_t;
+
+typedef struct{
+
+    long long rounds;
+    long long leaked_blocks;    //blocks allocated during the rounds and not freed at their end
+    long long leaked_bytes;
+    long long max_leaked_bytes; //worst round
+
+}alloc_round_t;
+
+/**
+ * Counters of a thread: plain data, so that the allocator can update them without running any constructor
+*/
+typedef struct{
+
+    alloc_stat_t stat[ALLOC_N_KEYS];
+    alloc_round_t round[PROFILE_N_VARIANTS];
+    long long live_blocks;  //blocks allocated - freed by the thread, to measure the rounds
+    long long live_bytes;
+
+}alloc_counters_t;
+
+class alloc_merger{
+    public:
+        int active= 0;  //set by the first round of the thread, so that the object is constructed outside the allocator
+
+        ~alloc_merger();    //merge the counters of the thread into the global ones at its exit
+};
+
+int alloc_enabled= 0;
+alloc_counters_t alloc_all; //counters of the exited threads
+mutex alloc_lock;
+thread_local alloc_counters_t alloc_tls;
+thread_local int alloc_key= -1; //step charged with the allocations of the thread -> -1 = not tracked
+thread_local int alloc_variant= 0;  //variant of the round being simulated
+thread_local long long alloc_round_blocks;  //live blocks at the start of the round
+thread_local long long alloc_round_bytes;
+thread_local alloc_merger alloc_exit;
+
+
+#ifdef ALLOC_TRACKING
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* ptr);
+}
+
+const unsigned int ALLOC_MAGIC= 0xBA4A110C;
+const size_t ALLOC_MIN_ALIGN= 16;   //alignment of malloc
+
+typedef struct{
+
+    size_t size;
+    size_t offset;  //distance of the block from the start of the allocation of the C library
+    int key;
+    unsigned int reserved[2];   //keeps the header a multiple of ALLOC_MIN_ALIGN
+    unsigned int magic; //right before the block -> check of the blocks passed to free
+
+}alloc_header_t;
+
+/**
+ * Allocate @size bytes aligned to @alignment (power of 2) with the header right before the block
+*/
+void* alloc_block(size_t alignment, size_t size){
+
+    if(alignment < ALLOC_MIN_ALIGN) alignment= ALLOC_MIN_ALIGN;
+    size_t offset= (sizeof(alloc_header_t) + alignment - 1) & ~(alignment - 1);    //room of the header, rounded to the alignment
+    if(size > (size_t) -1 - offset) return NULL;
+
+    char* base= (char*) ((alignment == ALLOC_MIN_ALIGN)?  __libc_malloc(offset + size) : __libc_memalign(alignment, offset + size));
+    if(base == NULL)    return NULL;
+
+    alloc_header_t* h= (alloc_header_t*) (base + offset) - 1;
+    h->size= size;
+    h->offset= offset;
+    h->key= (alloc_enabled)?  alloc_key : -1;
+    h->magic= ALLOC_MAGIC;
+
+    if(h->key >= 0){
+        alloc_tls.stat[h->key].allocs++;
+        alloc_tls.stat[h->key].bytes+= size;
+        alloc_tls.live_blocks++;
+        alloc_tls.live_bytes+= size;
+    }
+    return base + offset;
+}
+
+/**
+ * Return 1 if @alignment is a power of 2
+*/
+int alloc_power_of_2(size_t alignment)  {return alignment != 0 && (alignment & (alignment - 1)) == 0;}
+
+extern "C" void* malloc(size_t size)    {return alloc_block(ALLOC_MIN_ALIGN, size);}
+
+extern "C" void free(void* ptr){
+
+    if(ptr == NULL) return;
+
+    alloc_header_t* h= (alloc_header_t*) ptr - 1;
+    if(h->magic != ALLOC_MAGIC){    //every allocation function is interposed -> a foreign block is a bug of the caller
+        fprintf(stderr, "Alloc - free of a block not allocated by the tracker: %p\n", ptr);
+        abort();
+    }
+
+    if(h->key >= 0){
+        alloc_tls.stat[h->key].frees++;
+        alloc_tls.stat[h->key].freed_bytes+= h->size;
+        alloc_tls.live_blocks--;
+        alloc_tls.live_bytes-= h->size;
+    }
+    h->magic= 0;
+    __libc_free((char*) ptr - h->offset);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size){
+
+    if(!alloc_power_of_2(alignment)){
+        errno= EINVAL;
+        return NULL;
+    }
+    return alloc_block(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size)   {return memalign(alignment, size);}
+
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size){
+
+    if(!alloc_power_of_2(alignment) || alignment % sizeof(void*) != 0)  return EINVAL;
+
+    void* block= alloc_block(alignment, size);
+    if(block == NULL)   return ENOMEM;
+    *ptr= block;
+    return 0;
+}
+
+extern "C" void* valloc(size_t size)    {return alloc_block(sysconf(_SC_PAGESIZE), size);}
+
+extern "C" void* pvalloc(size_t size){
+
+    size_t page= sysconf(_SC_PAGESIZE);
+    return alloc_block(page, (size + page - 1) & ~(page - 1));
+}
+
+extern "C" void* calloc(size_t n, size_t size){
+
+    if(size != 0 && n > (size_t) -1 / size) return NULL;
+
+    void* ptr= malloc(n * size);
+    if(ptr != NULL) memset(ptr, 0, n * size);
+    return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size){
+
+    if(ptr == NULL) return malloc(size);
+    if(size == 0){
+        free(ptr);
+        return NULL;
+    }
+
+    void* block= malloc(size);
+    if(block == NULL)   return NULL;
+
+    alloc_header_t* h= (alloc_header_t*) ptr - 1;
+    memcpy(block, ptr, (h->size < size)?  h->size : size);
+    free(ptr);
+    return block;
+}
+
+extern "C" size_t malloc_usable_size(void* ptr){
+
+    return (ptr == NULL)?  0 : ((alloc_header_t*) ptr - 1)->size;
+}
+
+#endif  /*ALLOC_TRACKING*/
+
+
+alloc_merger::~alloc_merger(){
+
+    if(!active) return;
+
+    lock_guard <mutex> guard(alloc_lock);
+    for(int k=0; k<ALLOC_N_KEYS; ++k){
+        alloc_stat_t* a= &alloc_all.stat[k];
+        alloc_stat_t* s= &alloc_tls.stat[k];
+        a->handlings+= s->handlings;
+        a->allocs+= s->allocs;
+        a->bytes+= s->bytes;
+        a->frees+= s->frees;
+        a->freed_bytes+= s->freed_bytes;
+    }
+    for(int v=0; v<PROFILE_N_VARIANTS; ++v){
+        alloc_round_t* a= &alloc_all.round[v];
+        alloc_round_t* s= &alloc_tls.round[v];
+        a->rounds+= s->rounds;
+        a->leaked_blocks+= s->leaked_blocks;
+        a->leaked_bytes+= s->leaked_bytes;
+        if(s->max_leaked_bytes > a->max_leaked_bytes)   a->max_leaked_bytes= s->max_leaked_bytes;
+    }
+    memset(&alloc_tls, 0, sizeof(alloc_tls));   //the thread may still free blocks after the merge
+}
+
+/**
+ * Start the tracking of a round of the variant @handover_version/@is_attacker
+*/
+void alloc_round_begin(int handover_version, int is_attacker){
+
+    if(!alloc_enabled)  return;
+
+    alloc_exit.active= 1;   //first use in the thread -> merge at its exit
+    alloc_variant= handover_version + 2*is_attacker;
+    alloc_key= PROFILE_N_KEYS + alloc_variant;
+    alloc_round_blocks= alloc_tls.live_blocks;
+    alloc_round_bytes= alloc_tls.live_bytes;
+}
+
+/**
+ * Charge the next allocations of the thread to the step @key (handle_message), or to the rest of the round if @key < 0
+*/
+void alloc_step(int key){
+
+    if(!alloc_enabled)  return;
+
+    if(key >= 0){
+        alloc_key= key;
+        alloc_tls.stat[key].handlings++;
+    }else   alloc_key= PROFILE_N_KEYS + alloc_variant;
+}
+
+/**
+ * Stop charging the allocations of the thread -> @return the previous step, to be restored with alloc_resume
+*/
+int alloc_pause(){
+
+    int key= alloc_key;
+    alloc_key= -1;
+    return key;
+}
+
+void alloc_resume(int key){
+
+    alloc_key= key;
+}
+
+/**
+ * End the tracking of the round: the blocks allocated during the round and still live are counted as leaked
+*/
+void alloc_round_end(){
+
+    if(!alloc_enabled)  return;
+
+    alloc_key= -1;
+
+    alloc_round_t* r= &alloc_tls.round[alloc_variant];
+    long long bytes= alloc_tls.live_bytes - alloc_round_bytes;
+    r->rounds++;
+    r->leaked_blocks+= alloc_tls.live_blocks - alloc_round_blocks;
+    r->leaked_bytes+= bytes;
+    if(bytes > r->max_leaked_bytes) r->max_leaked_bytes= bytes;
+}
+
+/**
+ * Print the allocations of each step and the leaks -> registered with atexit(), after the exit of all the threads
+*/
+void alloc_report(){
+
+    alloc_enabled= 0;
+
+    for(int v=0; v<PROFILE_N_VARIANTS; ++v){
+
+        alloc_round_t* r= &alloc_all.round[v];
+        if(r->rounds == 0)  continue;
+
+        printf("\nALLOCATIONS - %s\n", PROFILE_VARIANTS[v]);
+        printf("  %lld rounds, leaked per round: %.2f blocks, %.1f bytes (worst round %lld bytes)\n", r->rounds,
+                (double) r->leaked_blocks / r->rounds, (double) r->leaked_bytes / r->rounds, r->max_leaked_bytes);
+        printf("  %-5s %-32s %10s %12s %12s %12s %14s\n", "", "", "count", "allocs/hand", "bytes/hand", "live blocks", "live bytes");
+
+        for(int kind=0; kind<PROFILE_LINK; ++kind){
+            for(int step=0; step<PROFILE_N_STEPS; ++step){
+
+                alloc_stat_t* s= &alloc_all.stat[(v * PROFILE_N_KINDS + kind) * PROFILE_N_STEPS + step];
+                if(s->handlings == 0)   continue;
+
+                printf("  %-5s %-32s %10lld %12.2f %12.1f %12lld %14lld\n", PROFILE_KINDS[kind], trace_msg_name(step), s->handlings,
+                        (double) s->allocs / s->handlings, (double) s->bytes / s->handlings, s->allocs - s->frees, s->bytes - s->freed_bytes);
+            }
+        }
+
+        alloc_stat_t* s= &alloc_all.stat[PROFILE_N_KEYS + v];    //rest of the round -> per round
+        printf("  %-38s %10lld %12.2f %12.1f %12lld %14lld\n", "rest of the round (per round)", r->rounds,
+                (double) s->allocs / r->rounds, (double) s->bytes / r->rounds, s->allocs - s->frees, s->bytes - s->freed_bytes);
+    }
+}
+
+#endif  /*ALLOC_H*/
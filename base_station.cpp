@@ -14,18 +14,11 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "message.cpp"
+#include "channel.cpp"
+#include "rng.cpp"
 
 using namespace std;
 
-const char MS_REP[]= "Measurement Report";
-const char HO_REQ[]= "Handover Request";
-const char HO_COM[]= "Handover Command";
-const char RACH[]= "RACH procedure";
-const char REC_REC[]= "Reconnection Recovery";
-const char REC_REC_OK[]= "Reconnection Recovery OK";
-const char REC_REC_REJ[]= "Reconnection Recovery Rejected";
-
 unsigned char ue_key[]= "djv0ncjodnon0nnn";
 
 
@@ -42,8 +35,8 @@ class base_station{
         int under_AMF;  //contains the ID of the AMF which this BS is controlled by
         int amf_index;  //index for transmitting messages to the AMF
 
-        unsigned char* auth_token;  //used only in the patched version - authenticates the BS
-        unsigned char* rec_token;   //used only in the patched version - reconnection recovery in case of attack
+        token_t auth_token;  //used only in the patched version - authenticates the BS
+        token_t rec_token;   //used only in the patched version - reconnection recovery in case of attack
         //-> here I take it as char* because transform in int only in case of reconnection -> if handover ok, then this would have been useless computation
 
         int is_patched; //descriminates whether to apply the patched version
@@ -61,8 +54,10 @@ class base_station{
         int get_active_context();   //return the value of active_context
 
         void activate_context(int UE_id); //set the UE_id as active context
+        void set_power(int power);  //set the transmission power
 
-        void handle_message(message* msg_channel[], message* msg, int* type_transmission);  //handle the incoming message and transmit the corresponding response
+        void handle_message(message_channel* msg_channel, message* msg, int* type_transmission);  //handle the incoming message and transmit the corresponding response
+        template <bool Patched> void handle_message(message_channel* msg_channel, message* msg, int* type_transmission);  //specialized on the handover variant
 };
 
 base_station::base_station(int id, int x, int y, int patched, int is_attacker, int amf_id, int amf_index){
@@ -86,91 +81,92 @@ int base_station::get_AMF()     {return under_AMF;}
 int base_station::get_active_context()  {return active_context;}
 
 void base_station::activate_context(int UE_id)    {active_context= UE_id;}
+void base_station::set_power(int power)    {t_power= power;}
+
+void base_station::handle_message(message_channel* msg_channel, message* msg, int* type_transmission){
+
+    if(is_patched)  handle_message<true>(msg_channel, msg, type_transmission);
+    else    handle_message<false>(msg_channel, msg, type_transmission);
+}
 
-void base_station::handle_message(message* msg_channel[], message* msg, int* type_transmission){
+template <bool Patched>
+void base_station::handle_message(message_channel* msg_channel, message* msg, int* type_transmission){
 
-    char* msg_type= msg->get_type();
+    msg_type_t msg_type= msg->get_type();
     
     //if(is_attacker) printf("BS %d (attacker) - Message received: %s\n", BS_id, msg_type);
     //else    printf("BS %d - Message received: %s\n", BS_id, msg_type);
 
-    if(!strcmp(msg_type, MS_REP)){   //Measurement report
+    if(msg_type == MSG_MEASUREMENT_REPORT){   //Measurement report
 
-        message* new_msg;
+        message new_msg;
         int content[]= {BS_id, msg->get_content(0), msg->get_content(1)};  //ID of base station, ID of user, ID of tBS
 
-        if(is_patched){            
-            unsigned char* temp= msg->get_token();  //extract the token -> dynamic memory stored
-            new_msg= new message("Handover Required", content, 3, temp);    //build the message with the token
+        if constexpr(Patched){            
+            new_msg= message(MSG_HANDOVER_REQUIRED, content, 3, msg->get_token());    //build the message with the token
+        }else   new_msg= message(MSG_HANDOVER_REQUIRED, content, 3); //build up the corresponding message
 
-            free(temp); //free the allocated space
-        }else   new_msg= new message("Handover Required", content, 3); //build up the corresponding message
+        msg_channel->post(amf_index, new_msg);    //transmit the message
 
-        msg_channel[amf_index]= new_msg;    //transmit the message
-
-        delete msg; //destroy the received message
-        msg_channel[BS_id]= NULL;   //clear the channel from the message received
+        msg_channel->clear(BS_id);   //clear the channel from the message received
 
         *type_transmission= 2;
         return;
     }
     
-    if(!strcmp(msg_type, HO_REQ)){   //Handover request
+    if(msg_type == MSG_HANDOVER_REQUEST){   //Handover request
 
-        if(is_patched)  auth_token= msg->get_token();   //if patched version then need to extract and store the authentication token
+        if constexpr(Patched)  auth_token= msg->get_token();   //if patched version then need to extract and store the authentication token
 
         int content[]= {};   //empty message
-        message* new_msg= new message("Handover ACK", content, 0); //build up the corresponding message
-        msg_channel[amf_index]= new_msg;    //transmit the message
+        message new_msg(MSG_HANDOVER_ACK, content, 0); //build up the corresponding message
+        msg_channel->post(amf_index, new_msg);    //transmit the message
 
-        delete msg; //destroy the received message
-        msg_channel[BS_id]= NULL;   //index 2 because the BS is the target -> NEED TO GENERALIZE
+        msg_channel->clear(BS_id);   //index 2 because the BS is the target -> NEED TO GENERALIZE
 
         *type_transmission= 2;
 
         return;
     }
 
-    if(!strcmp(msg_type, HO_COM)){  //Handover command
+    if(msg_type == MSG_HANDOVER_COMMAND){  //Handover command
 
-        if(is_patched)  rec_token= msg->get_token();    //if patched version then need to store the encrypted reconnection token 
+        if constexpr(Patched)  rec_token= msg->get_token();    //if patched version then need to store the encrypted reconnection token 
 
-        msg_channel[0]= msg;    //simulation of forwarding the message to UE
-        msg_channel[BS_id]= NULL;   //index 1 because the BS is the serving -> NEED TO GENERALIZE
+        msg_channel->post(0, *msg);    //simulation of forwarding the message to UE
+        msg_channel->clear(BS_id);   //index 1 because the BS is the serving -> NEED TO GENERALIZE
 
         *type_transmission= 6;
        
         return;   
     }
 
-    if(!strcmp(msg_type, RACH)){    //RACH procedure
+    if(msg_type == MSG_RACH){    //RACH procedure
 
         int content[0];
-        message* new_msg;
+        message new_msg;
 
         if(is_attacker){
 
-            int token= rand();  //get a random number
+            int token= sim_rand();  //get a random number
             unsigned char temp[4];
             unsigned char* temp1= (unsigned char*) &token;
             for(int i=0; i<4; ++i)  temp[i]= *(temp1 + i);
 
-            new_msg= new message("RACH OK", content, 0, temp1);  //generate the message
-            msg_channel[0]= new_msg;    //transmit the message
+            new_msg= message(MSG_RACH_OK, content, 0, temp, 4);  //generate the message
+            msg_channel->post(0, new_msg);    //transmit the message
 
-            delete msg; //destroy the received message
-            msg_channel[13]= NULL;   //index because the BS is the attacker --> TRY TO AUTOMATIZE IT
+            msg_channel->clear(13);   //index because the BS is the attacker --> TRY TO AUTOMATIZE IT
 
             *type_transmission= 6;
         }else{
 
-            if(is_patched)  new_msg= new message("RACH OK", content, 0, auth_token);
-            else new_msg= new message("RACH OK", content, 0); //build up the corresponding message
+            if constexpr(Patched)  new_msg= message(MSG_RACH_OK, content, 0, auth_token);
+            else new_msg= message(MSG_RACH_OK, content, 0); //build up the corresponding message
 
-            msg_channel[0]= new_msg;    //transmit the message
+            msg_channel->post(0, new_msg);    //transmit the message
 
-            delete msg; //destroy the received message
-            msg_channel[BS_id]= NULL;   //index 2 because the BS is the target
+            msg_channel->clear(BS_id);   //index 2 because the BS is the target
 
             *type_transmission= 6;
         }
@@ -178,95 +174,92 @@ void base_station::handle_message(message* msg_channel[], message* msg, int* typ
         return;        
     }
 
-    if(!strcmp(msg_type, REC_REC)){ //Reconnection Recovering
+    if constexpr(Patched){  //the reconnection recovery exists only in the patched version
+
+        if(msg_type == MSG_RECONNECTION){ //Reconnection Recovering
         
-        if(active_context == msg->get_content(0)){
-            //printf("BS %d - active context for UE: %d\n", BS_id, active_context);
-            //if the context for the UE is active, then no need to pass through the AMF
+            if(active_context == msg->get_content(0)){
+                //printf("BS %d - active context for UE: %d\n", BS_id, active_context);
+                //if the context for the UE is active, then no need to pass through the AMF
         
-            unsigned char temp[4];
-            for(int i=0; i<4; ++i)  temp[i]= rec_token[12+i];   //extraction of the 4 least-significant bytes
-            for(int i=0; i<4; ++i)  temp[i]^= ue_key[i];    //apply the XOR transformation
-
-            unsigned char* temp1= msg->get_token(); //extraction of the received token
-            int check= 1;   //used for signal reconnection token correctness
-
-            //verification of the reconnection token
-            for(int i=0; i<4; ++i){
-                if(temp[i] != temp1[i]){    //if do not correspond => can not accept the reconnection
-                    check= 0;
-                    break;
+                unsigned char temp[4];
+                for(int i=0; i<4; ++i)  temp[i]= rec_token[12+i];   //extraction of the 4 least-significant bytes
+                for(int i=0; i<4; ++i)  temp[i]^= ue_key[i];    //apply the XOR transformation
+
+                const token_t& received= msg->get_token(); //received token
+                int check= 1;   //used for signal reconnection token correctness
+
+                //verification of the reconnection token
+                for(int i=0; i<4; ++i){
+                    if(temp[i] != received[i]){    //if do not correspond => can not accept the reconnection
+                        check= 0;
+                        break;
+                    }
                 }
-            }
 
-            free(temp1);
+                int content[0];
+                message new_msg;
 
-            int content[0];
-            message* new_msg;
-
-            if(check){  //if authentication ok -> accept the reconnection
+                if(check){  //if authentication ok -> accept the reconnection
                 
-                int temp2= 0;
-                temp1= (unsigned char*) &temp2;
-                for(int i=0; i<4; ++i)  *(temp1 + i)= temp[i];  //move the reconnection token value into an int container
+                    int temp2= 0;
+                    unsigned char* temp1= (unsigned char*) &temp2;
+                    for(int i=0; i<4; ++i)  *(temp1 + i)= temp[i];  //move the reconnection token value into an int container
 
-                temp2+= 1;
-                //printf("BS %d - reconnection ok, new token: %u\n", BS_id, temp2);
+                    temp2+= 1;
+                    //printf("BS %d - reconnection ok, new token: %u\n", BS_id, temp2);
 
-                unsigned char temp3[4];
-                temp1= (unsigned char*) &temp2;
-                for(int i=0; i<4; ++i)  temp3[i]= *(temp1 + i); //move the updated token into a string container
+                    unsigned char temp3[4];
+                    temp1= (unsigned char*) &temp2;
+                    for(int i=0; i<4; ++i)  temp3[i]= *(temp1 + i); //move the updated token into a string container
 
-                new_msg= new message("Reconnection Recovery OK", content, 0, temp3);    //building the message
+                    new_msg= message(MSG_RECONNECTION_OK, content, 0, temp3, 4);    //building the message
 
-            }else   new_msg= new message("Reconnection Recovery Rejected", content, 0);
+                }else   new_msg= message(MSG_RECONNECTION_REJECTED, content, 0);
 
-            msg_channel[0]= new_msg;    //transmit the message to UE
+                msg_channel->post(0, new_msg);    //transmit the message to UE
 
-            delete msg; //destroy the received message
-            msg_channel[BS_id]= NULL;
+                msg_channel->clear(BS_id);
 
-            *type_transmission= 6;        
-            return;
+                *type_transmission= 6;        
+                return;
 
-        }else{
-            //printf("BS %d - NO active context for UE\n", BS_id);
+            }else{
+                //printf("BS %d - NO active context for UE\n", BS_id);
             
-            //if no active context for the UE, need to forward the message to the AMF
-            int content[]= {BS_id, 1, msg->get_content(0), msg->get_content(1)};   //BS id, is_BS: 0= no (-> is AMF) 1= yes, UE id, AMF id
-            unsigned char* temp= msg->get_token();
-
-            message* new_msg= new message("Reconnection Recovery", content, 4, temp);
+                //if no active context for the UE, need to forward the message to the AMF
+                int content[]= {BS_id, 1, msg->get_content(0), msg->get_content(1)};   //BS id, is_BS: 0= no (-> is AMF) 1= yes, UE id, AMF id
+                message new_msg(MSG_RECONNECTION, content, 4, msg->get_token());
             
-            msg_channel[amf_index]= new_msg;
+                msg_channel->post(amf_index, new_msg);
 
-            delete msg;
-            msg_channel[BS_id]= NULL;
+                msg_channel->clear(BS_id);
 
-            *type_transmission= 2;
-            return;
+                *type_transmission= 2;
+                return;
+            }
         }
-    }
 
-    if(!strcmp(msg_type, REC_REC_OK)){  //Reconnection Recovery OK
-        //this type of message can arrive only from the AMF -> need just to forward the message
+        if(msg_type == MSG_RECONNECTION_OK){  //Reconnection Recovery OK
+            //this type of message can arrive only from the AMF -> need just to forward the message
 
-        msg_channel[0]= msg;
-        msg_channel[BS_id]= NULL;
+            msg_channel->post(0, *msg);
+            msg_channel->clear(BS_id);
 
-        *type_transmission= 6;
-        return;
-    }
+            *type_transmission= 6;
+            return;
+        }
 
-    if(!strcmp(msg_type, REC_REC_REJ)){  //Reconnection Recovery OK
-        //this type of message can arrive only from the AMF -> need just to forward the message
+        if(msg_type == MSG_RECONNECTION_REJECTED){  //Reconnection Recovery OK
+            //this type of message can arrive only from the AMF -> need just to forward the message
 
-        msg_channel[0]= msg;
-        msg_channel[BS_id]= NULL;
+            msg_channel->post(0, *msg);
+            msg_channel->clear(BS_id);
 
-        *type_transmission= 6;
-        return;
-    }
+            *type_transmission= 6;
+            return;
+        }
+    } //#if(Patched)
 }
 
 
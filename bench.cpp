@@ -0,0 +1,268 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the micro-benchmarks of the protocol steps, as a separate executable:
+            g++ -std=gnu++20 -O2 bench.cpp -o bench -lpthread
+        There is one case per protocol step (UE Measurement Report transmission and the handle_message of UE, BS, rBS
+        and AMF for each message type, see costmodel.cpp), for the standard and the BARON handover, without and under
+        attack (reconnection recovery steps).
+        The state of each case is prepared by running real rounds: right before the step, the handling entity and the
+        message are cloned and the step is executed and timed --repeat times on the clones, in isolation, with the
+        random generator restored after each execution.
+        The results (median, minimum, p90 in ns per case) are written in JSON, which is also the cost profile of the
+        modeled-cost mode (--cost-model). With --baseline the results are compared with a stored JSON and the cases
+        slower than the tolerance are reported as regressions (exit code 1).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "config.cpp"
+#include "simulation.cpp"
+#include "measure.cpp"
+
+using namespace std;
+
+const int BENCH_N_VARIANTS= 4;
+const int BENCH_VARIANTS[BENCH_N_VARIANTS][2]= {{0, 0}, {1, 0}, {0, 1}, {1, 1}};    //handover version, attacker
+const char* BENCH_VARIANT_NAMES[BENCH_N_VARIANTS]= {"std", "patch", "std_att", "patch_att"};
+
+typedef struct{
+
+    int rounds; //prepared rounds per variant
+    int repeat; //executions of each step on the prepared state
+    int warmup; //rounds simulated before the measurements
+    int seed;
+    char out[256];  //JSON results
+    char baseline[256]; //JSON baseline for the comparison -> empty = no comparison
+    double tolerance;   //relative slow-down of the median considered a regression
+    char pin_cpus[256];
+
+}bench_config_t;
+
+typedef struct{
+
+    const char* name;
+    const char* variant;
+    int samples;
+    double median;  //ns
+    double min;
+    double p90;
+
+}bench_result_t;
+
+vector <double> bench_samples[BENCH_N_VARIANTS][N_STEP_CASES];    //ns
+int bench_variant= 0;   //variant being measured
+int bench_repeat= 1;
+
+
+/**
+ * Round hook: time the next step on clones of the entity and of the message
+*/
+void bench_hook(user* ue, vector <base_station*>* bs, vector <AMF*>* amf, message_channel* msg, int h, int n_bs, double channel[][2]){
+
+    vector <double>* samples;
+
+    if(h == -1){    //Measurement Report transmission
+        samples= &bench_samples[bench_variant][0];
+
+        for(int k=0; k<bench_repeat; ++k){
+            message_channel scratch(n_bs+3);
+
+            user clone= *ue;
+            unsigned long long saved= rng_state;
+            unsigned long long start= timer_start();
+            if(BENCH_VARIANTS[bench_variant][0])    clone.transmit_message<true>(&scratch, MSG_MEASUREMENT_REPORT);
+            else    clone.transmit_message<false>(&scratch, MSG_MEASUREMENT_REPORT);
+            unsigned long long stop= timer_stop();
+            rng_state= saved;
+
+            samples->push_back(timer_seconds(start, stop) * 1e9);
+        }
+        return;
+    }
+
+    int is_attacker= BENCH_VARIANTS[bench_variant][1];
+    int kind= (h == 0)?  PROFILE_UE : (h > n_bs)?  PROFILE_AMF : (is_attacker && h == n_bs)?  PROFILE_RBS : PROFILE_BS;
+
+    int c= step_case(kind, msg->get(h)->get_type(), 0);
+    if(c == -1) return;
+
+    samples= &bench_samples[bench_variant][c];
+    for(int k=0; k<bench_repeat; ++k){
+        double t= (BENCH_VARIANTS[bench_variant][0])?  time_clone<true>(ue, bs, amf, msg, h, n_bs, channel) : time_clone<false>(ue, bs, amf, msg, h, n_bs, channel);
+        samples->push_back(t * 1e9);
+    }
+}
+
+/**
+ * Return the quantile @p of the sorted @v
+*/
+double bench_quantile(vector <double>* v, double p){
+
+    int i= (int) (p * (v->size() - 1) + 0.5);
+    return (*v)[i];
+}
+
+/**
+ * Read the baseline @file_name. Return 0 in case of error
+*/
+int read_baseline(const char* file_name, vector <bench_result_t>* baseline, vector <string>* names){
+
+    FILE* f= fopen(file_name, "r");
+    if(f == NULL){
+        printf("Bench - can not open %s\n", file_name);
+        return 0;
+    }
+
+    char line[512];
+    while(fgets(line, sizeof(line), f) != NULL){
+        char name[64], variant[32];
+        bench_result_t r;
+        if(!parse_step_line(line, name, variant, &r.samples, &r.median, &r.min, &r.p90))    continue;
+
+        names->push_back(string(name) + " " + variant);
+        baseline->push_back(r);
+    }
+
+    fclose(f);
+    return 1;
+}
+
+void print_bench_usage(const char* name){
+
+    printf("Usage: %s [options]\n", name);
+    printf("  --rounds N        prepared rounds per variant (default 200)\n");
+    printf("  --repeat K        executions of each step on the prepared state (default 20)\n");
+    printf("  --warmup N        rounds simulated before the measurements (default 200)\n");
+    printf("  --seed S          seed of the random generator (default 10)\n");
+    printf("  --timer T         clock: steady (default) or tsc\n");
+    printf("  --pin CPUS        pin the benchmark to the cores CPUS\n");
+    printf("  --out F           JSON results (default bench_results.json)\n");
+    printf("  --baseline F      compare the medians with the JSON results F\n");
+    printf("  --tolerance T     relative slow-down reported as regression (default 0.10)\n");
+}
+
+int main(int argc, char* argv[]){
+
+    bench_config_t cfg= {200, 20, 200, 10, "bench_results.json", "", 0.10, ""};
+    int tsc= 0;
+
+    for(int i=1; i<argc; ++i){
+        if(!strcmp(argv[i], "--rounds") && i+1 < argc) cfg.rounds= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat") && i+1 < argc) cfg.repeat= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--warmup") && i+1 < argc) cfg.warmup= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--seed") && i+1 < argc)   cfg.seed= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--timer") && i+1 < argc)  tsc= !strcmp(argv[++i], "tsc");
+        else if(!strcmp(argv[i], "--pin") && i+1 < argc)    copy_option(cfg.pin_cpus, argv[++i], sizeof(cfg.pin_cpus));
+        else if(!strcmp(argv[i], "--out") && i+1 < argc)    copy_option(cfg.out, argv[++i], sizeof(cfg.out));
+        else if(!strcmp(argv[i], "--baseline") && i+1 < argc)   copy_option(cfg.baseline, argv[++i], sizeof(cfg.baseline));
+        else if(!strcmp(argv[i], "--tolerance") && i+1 < argc)  cfg.tolerance= atof(argv[++i]);
+        else{
+            printf("Unknown option: %s\n", argv[i]);
+            print_bench_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(cfg.rounds <= 0 || cfg.repeat <= 0){
+        printf("The number of rounds and of executions must be positive\n");
+        return 1;
+    }
+
+    if(cfg.pin_cpus[0] && !parse_cpus(cfg.pin_cpus)){
+        printf("Invalid list of cores: %s\n", cfg.pin_cpus);
+        return 1;
+    }
+    pin_thread(0);
+
+    timer_init((tsc)?  TIMER_TSC : TIMER_STEADY);
+
+    topology_t topology;
+    default_topology(&topology, 1.0);
+    warm_up(&topology, cfg.seed, cfg.warmup, 1, 1, 1);
+
+    //prepared state: the steps of real rounds -> only rounds with a handover are counted
+    bench_repeat= cfg.repeat;
+    round_hook= bench_hook;
+
+    for(int v=0; v<BENCH_N_VARIANTS; ++v){
+        bench_variant= v;
+
+        int done= 0;
+        for(long long j=1; done < cfg.rounds; ++j){
+            seed_round(cfg.seed, j);
+
+            geometry_t g;
+            generate_geometry(&topology, &g, BENCH_VARIANTS[v][1]);
+
+            round_result_t r;
+            simulate_round(&topology, &g, BENCH_VARIANTS[v][0], BENCH_VARIANTS[v][1], &r);
+            done+= (r.handover_completed != 0);
+        }
+        printf("Bench - %s: %d rounds\n", BENCH_VARIANT_NAMES[v], done);
+    }
+
+    round_hook= NULL;
+
+    //results
+    vector <bench_result_t> results;
+    for(int v=0; v<BENCH_N_VARIANTS; ++v){
+        for(int c=0; c<N_STEP_CASES; ++c){
+            vector <double>* s= &bench_samples[v][c];
+            if(s->empty())  continue;
+
+            sort(s->begin(), s->end());
+            bench_result_t r= {STEP_CASES[c].name, BENCH_VARIANT_NAMES[v], (int) s->size(), bench_quantile(s, 0.5), (*s)[0], bench_quantile(s, 0.9)};
+            results.push_back(r);
+        }
+    }
+
+    FILE* write= fopen(cfg.out, "w");
+    if(write == NULL){
+        printf("Bench - can not open %s\n", cfg.out);
+        return 1;
+    }
+
+    fprintf(write, "{\n  \"timer\": \"%s\", \"rounds\": %d, \"repeat\": %d, \"seed\": %d,\n  \"cases\": [\n", (timer_mode == TIMER_TSC)?  "tsc" : "steady", cfg.rounds, cfg.repeat, cfg.seed);
+    for(int i=0; i<(int) results.size(); ++i){
+        bench_result_t* r= &results[i];
+        fprintf(write, "    {\"name\": \"%s\", \"variant\": \"%s\", \"samples\": %d, \"median_ns\": %.1f, \"min_ns\": %.1f, \"p90_ns\": %.1f}%s\n",
+                r->name, r->variant, r->samples, r->median, r->min, r->p90, (i+1 < (int) results.size())?  "," : "");
+    }
+    fprintf(write, "  ]\n}\n");
+    fclose(write);
+    printf("Results written in %s\n", cfg.out);
+
+    if(!cfg.baseline[0])    return 0;
+
+    //comparison with the baseline
+    vector <bench_result_t> baseline;
+    vector <string> names;
+    if(!read_baseline(cfg.baseline, &baseline, &names))    return 1;
+
+    int regressions= 0;
+    printf("\nCOMPARISON WITH %s (tolerance %.0f%%)\n", cfg.baseline, cfg.tolerance*100);
+    for(int i=0; i<(int) results.size(); ++i){
+        string name= string(results[i].name) + " " + results[i].variant;
+        int b= find(names.begin(), names.end(), name) - names.begin();
+        if(b == (int) names.size())   continue;
+
+        double ratio= results[i].median / baseline[b].median;
+        int regression= (ratio > 1.0 + cfg.tolerance);
+        regressions+= regression;
+
+        printf("  %-14s %-10s %10.1f -> %10.1f ns  %+6.1f%%%s\n", results[i].name, results[i].variant, baseline[b].median,
+                results[i].median, (ratio - 1.0)*100, (regression)?  "  REGRESSION" : "");
+    }
+
+    printf("%d regressions\n", regressions);
+    return regressions > 0;
+}
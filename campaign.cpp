@@ -0,0 +1,131 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the round loop of an adaptive campaign: draw of the round geometry (uniform with
+        prediction of the case scenario, or stratified), simulation of the handover and update of the case scenario
+        buckets with the sequential stopping.
+        The campaign state is self-contained and the random generator is per-thread, so several campaigns can be
+        run in parallel.
+*/
+
+#ifndef CAMPAIGN_H
+#define CAMPAIGN_H
+
+#include "config.cpp"
+#include "simulation.cpp"
+#include "stopping.cpp"
+#include "sampler.cpp"
+#include "columns.cpp"
+
+using namespace std;
+
+typedef struct{
+
+    bucket_t bucket[3]; //[0]= tBS in sAMF; [1]= tBS NOT in sAMF; [2]= reconnection with sBS (attack only)
+    int n_buckets;  //number of case scenarios of the campaign
+    int n_converged;    //number of case scenarios that do not need more samples
+    long long drawn;    //rounds drawn -> counter of the per-round random generator
+    long long simulated;    //rounds simulated
+    long long rejected; //stratified rounds simulated in a case scenario other than the drawn one -> discarded
+
+}campaign_t;
+
+
+void init_campaign(campaign_t* c, int is_attacker){
+
+    for(int k=0; k<3; ++k)  init_bucket(&c->bucket[k]);
+    c->n_buckets= 2 + is_attacker;
+    c->n_converged= 0;
+    c->drawn= 0;
+    c->simulated= 0;
+    c->rejected= 0;
+}
+
+/**
+ * Recount the converged case scenarios -> used after restoring the buckets from a checkpoint
+*/
+void count_converged(campaign_t* c){
+
+    c->n_converged= 0;
+    for(int k=0; k<c->n_buckets; ++k)   c->n_converged+= c->bucket[k].converged;
+}
+
+/**
+ * Draw and, if needed, simulate the next round of the campaign.
+ * @sampler is used only if the configuration asks for stratified sampling.
+ * Return 0 once all the case scenarios converged.
+*/
+int campaign_round(config_t* cfg, topology_t* topology, sampler_t* sampler, campaign_t* c){
+
+    if(c->n_converged >= c->n_buckets)  return 0;
+
+    int handover_version= cfg->handover_version;
+    int is_attacker= cfg->is_attacker;
+    bucket_t* bucket= c->bucket;
+
+    c->drawn++;
+    seed_round(cfg->seed, c->drawn);    //the round is fully determined by its counter
+
+    geometry_t g;
+    int k;
+    double weight= 1.0;
+
+    if(cfg->stratified){
+        k= 0;   //case scenario with the fewest samples among the ones not converged
+        for(int i=0; i<c->n_buckets; ++i){
+            if(!bucket[i].converged && (k == 0 || bucket[i].samples.size() < bucket[k-1].samples.size()))   k= i+1;
+        }
+
+        weight= sample_geometry(sampler, k, &g);
+        if(weight < 0){ //case scenario unreachable in this topology
+            bucket[k-1].converged= 1;
+            c->n_converged++;
+            return c->n_converged < c->n_buckets;
+        }
+
+    }else{
+        generate_geometry(topology, &g, is_attacker);
+
+        k= predict_bucket(topology, &g, handover_version, is_attacker);
+        if(k == 0 || bucket[k-1].converged) return 1;   //skip the rounds of the converged case scenarios
+    }
+
+    round_result_t r;
+    simulate_round(topology, &g, handover_version, is_attacker, &r);
+    c->simulated++;
+
+    int drawn_k= k;
+    k= classify_round(&r, is_attacker);
+
+    //the importance weight holds only for the case scenario the geometry was drawn for (e.g. the rBS passing the
+    //authentication is not predicted) -> the other rounds are discarded
+    if(cfg->stratified && k != drawn_k){
+        c->rejected++;
+        columns_add(c->drawn, cfg->seed, handover_version, is_attacker, 0, &r);
+        return 1;
+    }
+
+    if(k == 0 || bucket[k-1].converged){
+        columns_add(c->drawn, cfg->seed, handover_version, is_attacker, 0, &r);
+        return 1;
+    }
+    columns_add(c->drawn, cfg->seed, handover_version, is_attacker, k, &r);
+
+    add_sample(&bucket[k-1], r.time, weight, cfg->ci_width, cfg->confidence, cfg->n_rounds);
+    if(bucket[k-1].converged)   c->n_converged++;
+
+    return c->n_converged < c->n_buckets;
+}
+
+/**
+ * Return the median of the case scenario @k (0-based): weighted if the samples come from the stratified sampling
+*/
+double campaign_median(campaign_t* c, int k){
+
+    return weighted_quantile(&c->bucket[k].samples, &c->bucket[k].weights, 0.5);
+}
+
+#endif  /*CAMPAIGN_H*/
@@ -0,0 +1,105 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file defines the message channel of a round: one slot per entity (0 = UE, 1..n_bs = BSs, n_bs+1 = AMF-1,
+        n_bs+2 = AMF-2) holding by value the message to be delivered to it.
+        The slots holding a message are marked in a ready bitmap with a second-level summary (bit w set if the word w
+        is not zero), updated by post and clear, so that the first and the last ready slot are found with ctz/clz on
+        two words for up to 4096 slots instead of scanning all the slots after each step.
+*/
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <vector>
+#include <algorithm>
+
+#include "message.cpp"
+
+using namespace std;
+
+class message_channel{
+
+    private:
+        vector <message> slots;
+        vector <unsigned long long> ready;  //bit i -> slot i holds a message
+        vector <unsigned long long> summary;    //bit w -> ready[w] != 0
+        int n_ready= 0;
+
+    public:
+        message_channel(int n_slots);
+
+        void reset();   //empty the channel, so that it can be reused by the next round
+
+        void post(int index, const message& msg);   //store @msg in the slot @index
+        void clear(int index);  //mark the slot @index as delivered
+        message* get(int index);    //return the message of the slot @index, NULL if none
+        int is_ready(int index);
+        int empty();
+        int first();    //lowest ready slot, -1 if none
+        int last(); //highest ready slot, -1 if none
+        int size();
+};
+
+message_channel::message_channel(int n_slots){
+
+    slots.resize(n_slots);
+    ready.assign((n_slots + 63) / 64, 0);
+    summary.assign((ready.size() + 63) / 64, 0);
+}
+
+void message_channel::reset(){
+
+    fill(ready.begin(), ready.end(), 0);
+    fill(summary.begin(), summary.end(), 0);
+    n_ready= 0;
+}
+
+void message_channel::post(int index, const message& msg){
+
+    slots[index]= msg;
+    if(is_ready(index)) return;
+
+    ready[index >> 6]|= 1ULL << (index & 63);
+    summary[index >> 12]|= 1ULL << ((index >> 6) & 63);
+    n_ready++;
+}
+
+void message_channel::clear(int index){
+
+    if(!is_ready(index))    return;
+
+    ready[index >> 6]&= ~(1ULL << (index & 63));
+    if(ready[index >> 6] == 0)  summary[index >> 12]&= ~(1ULL << ((index >> 6) & 63));
+    n_ready--;
+}
+
+message* message_channel::get(int index)    {return (is_ready(index))?  &slots[index] : NULL;}
+int message_channel::is_ready(int index)    {return (ready[index >> 6] >> (index & 63)) & 1;}
+int message_channel::empty()    {return n_ready == 0;}
+int message_channel::size()     {return slots.size();}
+
+int message_channel::first(){
+
+    for(int s=0; s<(int) summary.size(); ++s){
+        if(summary[s] == 0) continue;
+        int w= (s << 6) + __builtin_ctzll(summary[s]);
+        return (w << 6) + __builtin_ctzll(ready[w]);
+    }
+    return -1;
+}
+
+int message_channel::last(){
+
+    for(int s=summary.size()-1; s>=0; --s){
+        if(summary[s] == 0) continue;
+        int w= (s << 6) + 63 - __builtin_clzll(summary[s]);
+        return (w << 6) + 63 - __builtin_clzll(ready[w]);
+    }
+    return -1;
+}
+
+#endif  /*CHANNEL_H*/
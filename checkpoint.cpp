@@ -0,0 +1,349 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the checkpoint and resume of long simulation campaigns.
+        A checkpoint is a compact binary snapshot of the campaign state: hash of the configuration, round counter
+        (which also defines the state of the per-round random generator), number of simulated and rejected rounds and
+        the content of the case scenario buckets.
+        The samples of a bucket are only appended during a campaign, so the simulation thread hands over to a dedicated
+        thread just the samples added since the previous snapshot (O(new samples)); the writer thread keeps the complete
+        state, serializes it and writes it to disk, so that the simulation never waits for the I/O nor for the copy of
+        the whole sample set.
+
+        Binary format (native endianness):
+            "BARONCKP" | version (uint32) | config hash (uint64) | round (int64) | simulated (int64) | rejected (int64) |
+            n_buckets (int32)
+            for each bucket: converged (int32) | ci_low (double) | ci_high (double) | n (uint64) | samples (float[n]) | n_w (uint64) | weights (float[n_w])
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "config.cpp"
+#include "stopping.cpp"
+
+using namespace std;
+
+const char CHECKPOINT_MAGIC[]= "BARONCKP";
+const unsigned int CHECKPOINT_VERSION= 2;
+
+
+/**
+ * Return the FNV-1a hash of the configuration parameters that define the campaign results
+*/
+unsigned long long config_hash(config_t* cfg){
+
+    double values[]= {(double) cfg->handover_version, (double) cfg->is_attacker, (double) cfg->n_rounds, (double) cfg->seed,
+                      (double) cfg->paired, cfg->ci_width, cfg->confidence, (double) cfg->stratified};
+
+    unsigned long long hash= 14695981039346656037ULL;
+    unsigned char* bytes= (unsigned char*) values;
+    for(int i=0; i<(int) sizeof(values); ++i){
+        hash^= bytes[i];
+        hash*= 1099511628211ULL;
+    }
+
+    //modeled costs: the samples are not comparable with the measured ones
+    for(int i=0; cfg->cost_file[i]; ++i){
+        hash^= (unsigned char) cfg->cost_file[i];
+        hash*= 1099511628211ULL;
+    }
+    if(cfg->cost_file[0]){
+        bytes= (unsigned char*) &cfg->cost_scale;
+        for(int i=0; i<(int) sizeof(cfg->cost_scale); ++i){
+            hash^= bytes[i];
+            hash*= 1099511628211ULL;
+        }
+    }
+
+    //path loss model: the samples are not comparable with the free-space ones
+    if(cfg->pathloss != PATHLOSS_FREE || cfg->shadowing > 0){
+        double model[]= {(double) cfg->pathloss, cfg->pathloss_exp, cfg->carrier, cfg->shadowing, cfg->shadow_corr};
+        bytes= (unsigned char*) model;
+        for(int i=0; i<(int) sizeof(model); ++i){
+            hash^= bytes[i];
+            hash*= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+
+typedef struct{
+
+    int converged;
+    double ci_low, ci_high;
+    vector <float> samples; //in a delta: only the samples added since the previous snapshot
+    vector <float> weights;
+
+}checkpoint_bucket_t;
+
+typedef struct{
+
+    unsigned long long hash;
+    long long round, simulated, rejected;
+    vector <checkpoint_bucket_t> buckets;
+
+}checkpoint_state_t;
+
+class checkpointer{
+    private:
+        string file;    //name of the checkpoint file
+        thread writer;  //thread writing the snapshots to disk
+        mutex lock;
+        condition_variable cv;
+
+        vector <unsigned long long> sent_samples, sent_weights; //samples of each bucket already handed over -> simulation thread
+        vector <checkpoint_state_t> pending;    //deltas not yet applied by the writer thread
+        int stop= 0;
+        checkpoint_state_t state;   //complete state of the last snapshot -> writer thread
+
+        void write_loop();  //body of the writer thread
+        void write_file(vector <char>* data);   //write @data to the checkpoint file, atomically replacing the previous one
+
+    public:
+        checkpointer(const char* file_name);    //constructor -> starts the writer thread
+        ~checkpointer();    //writes the last pending snapshot and stops the writer thread
+
+        void save(unsigned long long hash, long long round, long long simulated, long long rejected, bucket_t* buckets[], int n_buckets);    //snapshot of the campaign state
+};
+
+
+/**
+ * Append @size bytes from @data to the buffer @b
+*/
+void put_bytes(vector <char>* b, const void* data, size_t size){
+
+    const char* p= (const char*) data;
+    b->insert(b->end(), p, p + size);
+}
+
+/**
+ * Read @size bytes from @f into @data. Return 1 on success
+*/
+int get_bytes(FILE* f, void* data, size_t size){
+
+    return fread(data, 1, size, f) == size;
+}
+
+checkpointer::checkpointer(const char* file_name){
+
+    file= file_name;
+    writer= thread(&checkpointer::write_loop, this);
+}
+
+checkpointer::~checkpointer(){
+
+    {
+        lock_guard <mutex> guard(lock);
+        stop= 1;
+    }
+    cv.notify_one();
+    writer.join();
+}
+
+void checkpointer::save(unsigned long long hash, long long round, long long simulated, long long rejected, bucket_t* buckets[], int n_buckets){
+
+    checkpoint_state_t delta= {hash, round, simulated, rejected, vector <checkpoint_bucket_t> (n_buckets)};
+    sent_samples.resize(n_buckets, 0);
+    sent_weights.resize(n_buckets, 0);
+
+    for(int k=0; k<n_buckets; ++k){
+        bucket_t* b= buckets[k];
+        checkpoint_bucket_t* d= &delta.buckets[k];
+
+        d->converged= b->converged;
+        d->ci_low= b->ci_low;
+        d->ci_high= b->ci_high;
+        d->samples.assign(b->samples.begin() + sent_samples[k], b->samples.end());
+        d->weights.assign(b->weights.begin() + sent_weights[k], b->weights.end());
+        sent_samples[k]= b->samples.size();
+        sent_weights[k]= b->weights.size();
+    }
+
+    {   //hand the delta over to the writer thread
+        lock_guard <mutex> guard(lock);
+        pending.push_back(move(delta));
+    }
+    cv.notify_one();
+}
+
+void checkpointer::write_loop(){
+
+    vector <checkpoint_state_t> deltas;
+    vector <char> data;
+
+    while(1){
+        {
+            unique_lock <mutex> guard(lock);
+            cv.wait(guard, [this]{return !pending.empty() || stop;});
+
+            if(pending.empty() && stop) return;
+
+            deltas.swap(pending);
+        }
+
+        for(int i=0; i<(int) deltas.size(); ++i){   //apply the deltas in order to the complete state
+            checkpoint_state_t* d= &deltas[i];
+            state.hash= d->hash;
+            state.round= d->round;
+            state.simulated= d->simulated;
+            state.rejected= d->rejected;
+            state.buckets.resize(d->buckets.size());
+
+            for(int k=0; k<(int) d->buckets.size(); ++k){
+                checkpoint_bucket_t* b= &state.buckets[k];
+                b->converged= d->buckets[k].converged;
+                b->ci_low= d->buckets[k].ci_low;
+                b->ci_high= d->buckets[k].ci_high;
+                b->samples.insert(b->samples.end(), d->buckets[k].samples.begin(), d->buckets[k].samples.end());
+                b->weights.insert(b->weights.end(), d->buckets[k].weights.begin(), d->buckets[k].weights.end());
+            }
+        }
+        deltas.clear();
+
+        int n_buckets= state.buckets.size();
+        data.clear();
+        put_bytes(&data, CHECKPOINT_MAGIC, 8);
+        put_bytes(&data, &CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION));
+        put_bytes(&data, &state.hash, sizeof(state.hash));
+        put_bytes(&data, &state.round, sizeof(state.round));
+        put_bytes(&data, &state.simulated, sizeof(state.simulated));
+        put_bytes(&data, &state.rejected, sizeof(state.rejected));
+        put_bytes(&data, &n_buckets, sizeof(n_buckets));
+
+        for(int k=0; k<n_buckets; ++k){
+            checkpoint_bucket_t* b= &state.buckets[k];
+            unsigned long long n= b->samples.size();
+            unsigned long long n_w= b->weights.size();
+
+            put_bytes(&data, &b->converged, sizeof(b->converged));
+            put_bytes(&data, &b->ci_low, sizeof(b->ci_low));
+            put_bytes(&data, &b->ci_high, sizeof(b->ci_high));
+            put_bytes(&data, &n, sizeof(n));
+            put_bytes(&data, b->samples.data(), n * sizeof(float));
+            put_bytes(&data, &n_w, sizeof(n_w));
+            put_bytes(&data, b->weights.data(), n_w * sizeof(float));
+        }
+
+        write_file(&data);
+    }
+}
+
+void checkpointer::write_file(vector <char>* data){
+
+    string tmp= file + ".tmp";
+
+    FILE* f= fopen(tmp.c_str(), "wb");
+    if(f == NULL){
+        printf("Checkpoint - can not open %s\n", tmp.c_str());
+        return;
+    }
+
+    fwrite(data->data(), 1, data->size(), f);
+    fflush(f);
+    fsync(fileno(f));
+    fclose(f);
+
+    rename(tmp.c_str(), file.c_str());  //the previous checkpoint is replaced only by a complete one
+}
+
+/**
+ * Read the header of the checkpoint @f (@file_name) up to the configuration hash.
+ * Return 0 if it is not a valid checkpoint or was produced by a different configuration (@hash).
+*/
+int checkpoint_header(FILE* f, const char* file_name, unsigned long long hash){
+
+    char magic[8];
+    unsigned int version;
+    unsigned long long file_hash;
+
+    if(!get_bytes(f, magic, 8) || memcmp(magic, CHECKPOINT_MAGIC, 8) || !get_bytes(f, &version, sizeof(version)) || version != CHECKPOINT_VERSION){
+        printf("Checkpoint - %s is not a valid checkpoint\n", file_name);
+        return 0;
+    }
+
+    if(!get_bytes(f, &file_hash, sizeof(file_hash)) || file_hash != hash){
+        printf("Checkpoint - %s was produced by a different configuration\n", file_name);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Store in @round the round counter of the checkpoint @file_name -> the per-round outputs are cut there on --resume.
+ * Return 0 if the checkpoint can not be used (see load_checkpoint).
+*/
+int checkpoint_round(const char* file_name, unsigned long long hash, long long* round){
+
+    FILE* f= fopen(file_name, "rb");
+    if(f == NULL){
+        printf("Checkpoint - can not open %s\n", file_name);
+        return 0;
+    }
+
+    int ok= checkpoint_header(f, file_name, hash) && get_bytes(f, round, sizeof(*round));
+    fclose(f);
+    return ok;
+}
+
+/**
+ * Load the campaign state from the checkpoint @file_name into @buckets, @round, @simulated and @rejected.
+ * Return 1 on success, 0 if the file is missing, corrupted or was produced by a different configuration (@hash).
+*/
+int load_checkpoint(const char* file_name, unsigned long long hash, long long* round, long long* simulated, long long* rejected, bucket_t* buckets[], int n_buckets){
+
+    FILE* f= fopen(file_name, "rb");
+    if(f == NULL){
+        printf("Checkpoint - can not open %s\n", file_name);
+        return 0;
+    }
+
+    int file_buckets;
+
+    if(!checkpoint_header(f, file_name, hash)){
+        fclose(f);
+        return 0;
+    }
+
+    int ok= get_bytes(f, round, sizeof(*round)) && get_bytes(f, simulated, sizeof(*simulated)) && get_bytes(f, rejected, sizeof(*rejected));
+    ok= ok && get_bytes(f, &file_buckets, sizeof(file_buckets)) && file_buckets == n_buckets;
+
+    for(int k=0; ok && k<n_buckets; ++k){
+        bucket_t* b= buckets[k];
+        unsigned long long n, n_w;
+
+        ok= get_bytes(f, &b->converged, sizeof(b->converged)) && get_bytes(f, &b->ci_low, sizeof(b->ci_low)) && get_bytes(f, &b->ci_high, sizeof(b->ci_high));
+        ok= ok && get_bytes(f, &n, sizeof(n));
+        if(ok){
+            b->samples.resize(n);
+            ok= get_bytes(f, b->samples.data(), n * sizeof(float));
+        }
+        ok= ok && get_bytes(f, &n_w, sizeof(n_w));
+        if(ok){
+            b->weights.resize(n_w);
+            ok= get_bytes(f, b->weights.data(), n_w * sizeof(float));
+        }
+    }
+
+    fclose(f);
+
+    if(!ok) printf("Checkpoint - %s is truncated\n", file_name);
+    return ok;
+}
+
+#endif  /*CHECKPOINT_H*/
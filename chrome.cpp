@@ -0,0 +1,193 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the export of sampled rounds in the Chrome trace-event JSON format (chrome://tracing,
+        Perfetto UI).
+        One round every --chrome-every (by round index, so the sample does not depend on the threads) is recorded in
+        a per-thread ring buffer keeping the last --chrome-rounds sampled rounds; the rings are collected when the
+        threads exit and written at the end of the run.
+        Each round is a process with one track per entity (UE, BSs, rBS, AMF-1, AMF-2) on the simulated time axis:
+        every hop is a processing span on the track of the handling entity followed by a propagation span on the same
+        track, with a flow arrow to the receiver.
+*/
+
+#ifndef CHROME_H
+#define CHROME_H
+
+#include <stdio.h>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+
+#include "profile.cpp"
+
+using namespace std;
+
+typedef struct{
+
+    int from;   //index in the message channel of the entity handling the message
+    int to; //index of the receiver of the answer
+    int msg_type;   //index in TRACE_MSG_TYPES of the handled message
+    double processing;  //s
+    double propagation; //s
+
+}chrome_hop_t;
+
+typedef struct{
+
+    long long round;
+    int handover_version;
+    int is_attacker;
+    int n_bs;
+    int sBS;
+    int tBS;
+    double time;    //overall handover execution time
+    vector <chrome_hop_t> hops;
+
+}chrome_round_t;
+
+class chrome_ring{
+    public:
+        vector <chrome_round_t> rounds; //ring buffer of the sampled rounds
+        long long n= 0; //rounds recorded so far -> next position: n % capacity
+        chrome_round_t current; //round being simulated
+
+        ~chrome_ring(); //hand the rounds over to the exporter at the exit of the thread
+};
+
+int chrome_enabled= 0;
+long long chrome_every= 100;    //sampling period (round index)
+int chrome_capacity= 64;    //sampled rounds kept per thread
+char chrome_file[256]= "";
+vector <chrome_round_t> chrome_all; //rounds of the exited threads
+mutex chrome_lock;
+thread_local chrome_ring chrome_tls;
+
+
+/**
+ * Return 1 if the round @round is sampled, and in that case start its record
+*/
+int chrome_begin(long long round, int handover_version, int is_attacker, int n_bs){
+
+    if(round % chrome_every != 0)   return 0;
+
+    chrome_round_t* c= &chrome_tls.current;
+    c->round= round;
+    c->handover_version= handover_version;
+    c->is_attacker= is_attacker;
+    c->n_bs= n_bs;
+    c->hops.clear();
+    return 1;
+}
+
+void chrome_hop(int from, int to, int msg_type, double processing, double propagation){
+
+    chrome_hop_t h= {from, to, msg_type, processing, propagation};
+    chrome_tls.current.hops.push_back(h);
+}
+
+/**
+ * Complete the record of the sampled round and store it in the ring buffer of the thread
+*/
+void chrome_end(int sBS, int tBS, double time){
+
+    chrome_ring* r= &chrome_tls;
+    r->current.sBS= sBS;
+    r->current.tBS= tBS;
+    r->current.time= time;
+
+    if((int) r->rounds.size() < chrome_capacity)  r->rounds.push_back(r->current);
+    else    r->rounds[r->n % chrome_capacity]= r->current;  //the oldest round is overwritten
+    r->n++;
+}
+
+chrome_ring::~chrome_ring(){
+
+    lock_guard <mutex> guard(chrome_lock);
+    chrome_all.insert(chrome_all.end(), rounds.begin(), rounds.end());
+}
+
+/**
+ * Write the name of the track @index of the round @c in @name
+*/
+void chrome_track_name(chrome_round_t* c, int index, char* name){
+
+    if(index == 0)  sprintf(name, "UE");
+    else if(index == c->n_bs + 1)   sprintf(name, "AMF-1");
+    else if(index == c->n_bs + 2)   sprintf(name, "AMF-2");
+    else if(c->is_attacker && index == c->n_bs) sprintf(name, "rBS");
+    else if(index == c->sBS)    sprintf(name, "BS %d (sBS)", index);
+    else if(index == c->tBS)    sprintf(name, "BS %d (tBS)", index);
+    else    sprintf(name, "BS %d", index);
+}
+
+/**
+ * Write the sampled rounds in @chrome_file -> registered with atexit(), after the exit of all the threads
+*/
+void chrome_export(){
+
+    FILE* write= fopen(chrome_file, "w");
+    if(write == NULL){
+        printf("Chrome trace - can not open %s\n", chrome_file);
+        return;
+    }
+
+    sort(chrome_all.begin(), chrome_all.end(), [](const chrome_round_t& a, const chrome_round_t& b){   //one process per round, by round index
+        if(a.round != b.round)  return a.round < b.round;
+        return a.handover_version + 2*a.is_attacker < b.handover_version + 2*b.is_attacker;
+    });
+
+    fprintf(write, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    const char* sep= "";
+    long long flow= 0;
+
+    for(int p=0; p<(int) chrome_all.size(); ++p){
+        chrome_round_t* c= &chrome_all[p];
+        char name[64];
+
+        fprintf(write, "%s{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": %d, \"args\": {\"name\": \"round %lld %s (%.3f us)\"}}", sep, p, c->round,
+                PROFILE_VARIANTS[c->handover_version + 2*c->is_attacker], c->time*1e6);
+        sep= ",\n";
+
+        vector <int> used(c->n_bs + 3, 0);
+        for(int i=0; i<(int) c->hops.size(); ++i) used[c->hops[i].from]= used[c->hops[i].to]= 1;
+        for(int t=0; t<c->n_bs+3; ++t){
+            if(!used[t])    continue;
+            chrome_track_name(c, t, name);
+            fprintf(write, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}}", sep, p, t, name);
+            fprintf(write, "%s{\"ph\": \"M\", \"name\": \"thread_sort_index\", \"pid\": %d, \"tid\": %d, \"args\": {\"sort_index\": %d}}", sep, p, t, t);
+        }
+
+        double ts= 0.0; //simulated time (us)
+        for(int i=0; i<(int) c->hops.size(); ++i){
+            chrome_hop_t* h= &c->hops[i];
+            const char* msg= trace_msg_name(h->msg_type);
+
+            if(h->processing > 0){
+                fprintf(write, "%s{\"ph\": \"X\", \"cat\": \"processing\", \"name\": \"%s\", \"pid\": %d, \"tid\": %d, \"ts\": %.4f, \"dur\": %.4f}",
+                        sep, msg, p, h->from, ts, h->processing*1e6);
+                ts+= h->processing*1e6;
+            }
+
+            if(h->to != h->from){
+                chrome_track_name(c, h->to, name);
+                fprintf(write, "%s{\"ph\": \"X\", \"cat\": \"propagation\", \"name\": \"-> %s\", \"pid\": %d, \"tid\": %d, \"ts\": %.4f, \"dur\": %.4f}",
+                        sep, name, p, h->from, ts, h->propagation*1e6);
+                fprintf(write, "%s{\"ph\": \"s\", \"cat\": \"message\", \"name\": \"message\", \"id\": %lld, \"pid\": %d, \"tid\": %d, \"ts\": %.4f}", sep, flow, p, h->from, ts);
+                ts+= h->propagation*1e6;
+                fprintf(write, "%s{\"ph\": \"f\", \"bp\": \"e\", \"cat\": \"message\", \"name\": \"message\", \"id\": %lld, \"pid\": %d, \"tid\": %d, \"ts\": %.4f}", sep, flow, p, h->to, ts);
+                flow++;
+            }
+        }
+    }
+
+    fprintf(write, "\n]}\n");
+    fclose(write);
+
+    printf("Chrome trace: %d sampled rounds written in %s\n", (int) chrome_all.size(), chrome_file);
+}
+
+#endif  /*CHROME_H*/
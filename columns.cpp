@@ -0,0 +1,454 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the binary columnar output of the rounds (--columns F) and its CSV exporter:
+            baron export results.bin [results.csv]
+        Every simulated round is a row of float64 columns: round index, seed, variant (handover version + 2 * attacker),
+        case scenario in which the round was counted (0 = not counted), outcome (handover_completed), total time,
+        propagation time and the handling time of each message type.
+        Layout (little endian, every offset a multiple of 8, so the file can be mapped and read in place):
+            - header of 64 bytes: magic "BARONCOL", version, number of columns, rows per block, offset of the data,
+              number of rows, followed by the column names (32 bytes each), in the first 4096 bytes
+            - from the data offset, blocks of COLUMNS_BLOCK_ROWS rows: inside a block, each column is contiguous. The
+              last block is padded, so the value of column c of row i is at: data + (i / R) * R * C * 8 + c * R * 8 + (i % R) * 8
+        The simulation threads do not write: each one pushes its rows in its own single-producer ring, and a writer
+        thread drains the rings into the current block and writes full blocks with pwrite (4096-byte aligned buffer,
+        size and offset, so the file can also be opened with O_DIRECT, --columns-direct). The memory does not depend
+        on the number of rounds; if the writer falls behind, the simulation threads wait on their full ring.
+        At every checkpoint the writer also writes the current (partial) block and the header, so that with --resume
+        the file is reopened, cut after the last row of the checkpoint round and continued from there.
+*/
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+#include "simulation.cpp"
+
+using namespace std;
+using namespace chrono;
+
+const char COLUMNS_MAGIC[8]= {'B', 'A', 'R', 'O', 'N', 'C', 'O', 'L'};
+const unsigned int COLUMNS_VERSION= 2;
+const int COLUMNS_ALIGN= 4096;  //O_DIRECT alignment of buffers, sizes and offsets
+const int COLUMNS_BLOCK_ROWS= 4096;
+const int COLUMNS_NAME_SIZE= 32;
+const int COLUMNS_FIXED= 7;    //columns before the handling times
+const int COLUMNS_N= COLUMNS_FIXED + TRACE_N_MSG_TYPES;
+const char* COLUMNS_NAMES[COLUMNS_FIXED]= {"round", "seed", "variant", "scenario", "outcome", "time", "propagation"};
+const int COLUMNS_BLOCK_BYTES= COLUMNS_N * COLUMNS_BLOCK_ROWS * sizeof(double);  //multiple of COLUMNS_ALIGN
+const int COLUMNS_RING_ROWS= 8192;  //rows buffered per simulation thread
+
+typedef struct{
+
+    char magic[8];
+    unsigned int version;
+    unsigned int n_columns;
+    unsigned int block_rows;
+    unsigned int data_offset;   //offset of the first block
+    long long n_rows;
+    char padding[32];
+
+}columns_header_t;
+
+typedef struct{
+
+    double value[COLUMNS_N];
+
+}columns_row_t;
+
+/**
+ * Single-producer single-consumer ring of rows: the simulation thread pushes, the writer thread pops
+*/
+class columns_ring{
+    public:
+        columns_row_t rows[COLUMNS_RING_ROWS];
+        atomic <unsigned long long> head{0};    //next row to pop -> written by the consumer
+        atomic <unsigned long long> tail{0};    //next row to push -> written by the producer
+
+        void push(columns_row_t* row);  //wait while the ring is full
+        int pop(columns_row_t* row);    //return 0 if the ring is empty
+};
+
+class columns_writer{
+    public:
+        int fd;
+        double* block;  //COLUMNS_N columns of COLUMNS_BLOCK_ROWS rows, aligned for O_DIRECT
+        long long n_rows= 0;
+        vector <columns_ring*> rings;   //one per simulation thread
+        mutex rings_lock;
+        atomic <int> stop{0};
+        atomic <int> sync{0};   //1 -> write the partial block and the header after draining the rings
+        thread worker;
+
+        columns_writer(int fd, long long n_rows);   //@n_rows rows already in the file -> resumed campaign
+        columns_ring* ring();   //ring of the calling thread
+        void close();   //drain the rings, write the last block and the number of rows
+
+    private:
+        int write_header();
+        void write_current();
+        void write_block();
+        void run(); //writer thread
+};
+
+columns_writer* columns_out= NULL;
+thread_local columns_ring* columns_tls= NULL;
+
+
+void columns_ring::push(columns_row_t* row){
+
+    unsigned long long t= tail.load(memory_order_relaxed);
+    while(t - head.load(memory_order_acquire) >= COLUMNS_RING_ROWS) this_thread::yield();   //back-pressure: the writer is behind
+
+    rows[t % COLUMNS_RING_ROWS]= *row;
+    tail.store(t + 1, memory_order_release);
+}
+
+int columns_ring::pop(columns_row_t* row){
+
+    unsigned long long h= head.load(memory_order_relaxed);
+    if(h == tail.load(memory_order_acquire))    return 0;
+
+    *row= rows[h % COLUMNS_RING_ROWS];
+    head.store(h + 1, memory_order_release);
+    return 1;
+}
+
+columns_writer::columns_writer(int fd, long long n_rows){
+
+    this->fd= fd;
+    this->n_rows= n_rows;
+    block= (double*) aligned_alloc(COLUMNS_ALIGN, COLUMNS_BLOCK_BYTES);
+    memset(block, 0, COLUMNS_BLOCK_BYTES);
+
+    int rows= n_rows % COLUMNS_BLOCK_ROWS;
+    if(rows){   //continue the partial last block: the rows after @n_rows are cleared
+        if(pread(fd, block, COLUMNS_BLOCK_BYTES, COLUMNS_ALIGN + (n_rows / COLUMNS_BLOCK_ROWS) * COLUMNS_BLOCK_BYTES) != COLUMNS_BLOCK_BYTES)   printf("Columns - read error\n");
+        for(int c=0; c<COLUMNS_N; ++c)  memset(block + c * COLUMNS_BLOCK_ROWS + rows, 0, (COLUMNS_BLOCK_ROWS - rows) * sizeof(double));
+    }
+
+    worker= thread(&columns_writer::run, this);
+}
+
+/**
+ * Write the header and the column names in the first COLUMNS_ALIGN bytes. Return 0 in case of error
+*/
+int columns_writer::write_header(){
+
+    char* buffer= (char*) aligned_alloc(COLUMNS_ALIGN, COLUMNS_ALIGN);
+    memset(buffer, 0, COLUMNS_ALIGN);
+
+    columns_header_t* h= (columns_header_t*) buffer;
+    memcpy(h->magic, COLUMNS_MAGIC, 8);
+    h->version= COLUMNS_VERSION;
+    h->n_columns= COLUMNS_N;
+    h->block_rows= COLUMNS_BLOCK_ROWS;
+    h->data_offset= COLUMNS_ALIGN;
+    h->n_rows= n_rows;
+
+    char* names= buffer + sizeof(columns_header_t);
+    for(int c=0; c<COLUMNS_N; ++c)  strncpy(names + c * COLUMNS_NAME_SIZE, (c < COLUMNS_FIXED)?  COLUMNS_NAMES[c] : TRACE_MSG_TYPES[c - COLUMNS_FIXED], COLUMNS_NAME_SIZE-1);
+
+    int ok= (pwrite(fd, buffer, COLUMNS_ALIGN, 0) == COLUMNS_ALIGN);
+    free(buffer);
+    return ok;
+}
+
+/**
+ * Write the current block (full, or padded with zeros) at its position
+*/
+void columns_writer::write_current(){
+
+    long long index= (n_rows - 1) / COLUMNS_BLOCK_ROWS;
+    if(pwrite(fd, block, COLUMNS_BLOCK_BYTES, COLUMNS_ALIGN + index * COLUMNS_BLOCK_BYTES) != COLUMNS_BLOCK_BYTES)  printf("Columns - write error\n");
+}
+
+/**
+ * Write the current block and clear it
+*/
+void columns_writer::write_block(){
+
+    write_current();
+    memset(block, 0, COLUMNS_BLOCK_BYTES);
+}
+
+void columns_writer::run(){
+
+    write_header(); //provisional: rows already in the file
+
+    columns_row_t row;
+    while(1){
+        int stopping= stop.load(memory_order_acquire); //read before draining -> no row pushed before the stop is lost
+        int syncing= sync.exchange(0, memory_order_acq_rel);    //same for the rows pushed before the checkpoint
+        int popped= 0;
+
+        vector <columns_ring*> current;
+        {
+            lock_guard <mutex> guard(rings_lock);
+            current= rings;
+        }
+
+        for(int r=0; r<(int) current.size(); ++r){
+            while(current[r]->pop(&row)){
+                int i= n_rows % COLUMNS_BLOCK_ROWS;
+                for(int c=0; c<COLUMNS_N; ++c)  block[c * COLUMNS_BLOCK_ROWS + i]= row.value[c];
+                n_rows++;
+                popped++;
+                if(n_rows % COLUMNS_BLOCK_ROWS == 0)    write_block();
+            }
+        }
+
+        if(syncing){
+            if(n_rows % COLUMNS_BLOCK_ROWS != 0)    write_current();
+            if(!write_header()) printf("Columns - write error\n");
+        }
+
+        if(stopping && popped == 0) break;
+        if(popped == 0) this_thread::sleep_for(microseconds(200));
+    }
+}
+
+columns_ring* columns_writer::ring(){
+
+    if(columns_tls == NULL){
+        columns_tls= new columns_ring();
+        lock_guard <mutex> guard(rings_lock);
+        rings.push_back(columns_tls);
+    }
+    return columns_tls;
+}
+
+void columns_writer::close(){
+
+    stop.store(1, memory_order_release);
+    worker.join();
+
+    if(n_rows % COLUMNS_BLOCK_ROWS != 0)    write_block();  //padded last block
+    if(!write_header()) printf("Columns - write error\n");
+    ::close(fd);
+
+    free(block);
+    for(int r=0; r<(int) rings.size(); ++r)   delete rings[r];
+}
+
+/**
+ * Map the complete columnar file @file_name in memory and store its size in @size.
+ * Return NULL in case of error (message prefixed by @module)
+*/
+const char* columns_map(const char* file_name, size_t* size, const char* module){
+
+    int fd= open(file_name, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(columns_header_t)){
+        printf("%s - can not read %s\n", module, file_name);
+        if(fd >= 0) close(fd);
+        return NULL;
+    }
+
+    const char* data= (const char*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        printf("%s - can not map %s\n", module, file_name);
+        return NULL;
+    }
+
+    const columns_header_t* h= (const columns_header_t*) data;
+    int valid= !memcmp(h->magic, COLUMNS_MAGIC, 8) && h->version == COLUMNS_VERSION && h->block_rows > 0 && h->n_columns == COLUMNS_N && h->n_rows >= 0;
+    if(valid){  //the layout is checked before its fields are used
+        long long n_blocks= (h->n_rows + h->block_rows - 1) / h->block_rows;
+        valid= (h->data_offset + n_blocks * h->block_rows * h->n_columns * sizeof(double) <= (size_t) st.st_size);
+    }
+    if(!valid){
+        printf("%s - %s is not a complete columnar results file\n", module, file_name);
+        munmap((void*) data, st.st_size);
+        return NULL;
+    }
+
+    *size= st.st_size;
+    return data;
+}
+
+/**
+ * Return the number of rows of the columnar file @file_name up to the round @round (included): the rows are in round
+ * order, since the campaigns with a checkpoint run on one thread. Return 0 if the file does not exist, -1 in case of error
+*/
+long long columns_rows_until(const char* file_name, long long round){
+
+    if(access(file_name, F_OK) != 0)    return 0;
+
+    size_t size;
+    const char* data= columns_map(file_name, &size, "Columns");
+    if(data == NULL)    return -1;
+
+    const columns_header_t* h= (const columns_header_t*) data;
+    const double* values= (const double*) (data + h->data_offset);
+
+    long long n= h->n_rows;
+    while(n > 0 && values[((n-1) / h->block_rows) * h->block_rows * h->n_columns + (n-1) % h->block_rows] > round)  n--;    //column 0 = round
+
+    munmap((void*) data, size);
+    return n;
+}
+
+/**
+ * Open the columnar output @file_name, with O_DIRECT if @direct. With @resume_round >= 0 (--resume) the rows up to
+ * that round are kept and the new rows follow them. Return 0 in case of error
+*/
+int columns_open(const char* file_name, int direct, long long resume_round){
+
+    long long n_rows= 0;
+    if(resume_round >= 0){
+        n_rows= columns_rows_until(file_name, resume_round);
+        if(n_rows < 0)  return 0;
+    }
+
+    int flags= O_RDWR | O_CREAT | ((resume_round >= 0)?  0 : O_TRUNC);
+    int fd= -1;
+#ifdef O_DIRECT
+    if(direct){
+        fd= open(file_name, flags | O_DIRECT, 0644);
+        if(fd < 0)  printf("Columns - O_DIRECT not supported for %s: buffered writes\n", file_name);
+    }
+#endif
+    if(fd < 0)  fd= open(file_name, flags, 0644);
+    if(fd < 0){
+        printf("Columns - can not open %s\n", file_name);
+        return 0;
+    }
+
+    long long n_blocks= (n_rows + COLUMNS_BLOCK_ROWS - 1) / COLUMNS_BLOCK_ROWS;
+    if(resume_round >= 0 && ftruncate(fd, COLUMNS_ALIGN + n_blocks * COLUMNS_BLOCK_BYTES) != 0){   //drop the rows after the checkpoint
+        printf("Columns - can not truncate %s\n", file_name);
+        close(fd);
+        return 0;
+    }
+
+    columns_out= new columns_writer(fd, n_rows);
+    record_steps= 1;
+    return 1;
+}
+
+/**
+ * Ask the writer to write the rows pushed so far, with the header -> called at every checkpoint
+*/
+void columns_sync(){
+
+    if(columns_out != NULL) columns_out->sync.store(1, memory_order_release);
+}
+
+/**
+ * Close the columnar output -> registered with atexit()
+*/
+void columns_close(){
+
+    if(columns_out == NULL) return;
+
+    columns_out->close();
+    delete columns_out;
+    columns_out= NULL;
+    record_steps= 0;
+}
+
+/**
+ * Add the round @round of the variant @handover_version/@is_attacker, counted in the case scenario @scenario (0 = not counted).
+ * The row goes to the ring of the calling thread
+*/
+void columns_add(long long round, unsigned int seed, int handover_version, int is_attacker, int scenario, round_result_t* r){
+
+    if(columns_out == NULL) return;
+
+    columns_row_t row= {{(double) round, (double) seed, (double) (handover_version + 2*is_attacker), (double) scenario, (double) r->handover_completed, r->time, r->propagation}};
+    for(int m=0; m<TRACE_N_MSG_TYPES; ++m)  row.value[COLUMNS_FIXED + m]= r->step_time[m];
+
+    columns_out->ring()->push(&row);
+}
+
+/**
+ * Store in @samples, in row order, the total time of the rows of the variant @variant (handover version + 2 * attacker)
+ * counted in the case scenario @scenario of the columnar file @file_name -> grouped results of a streamed campaign.
+ * Return 0 in case of error
+*/
+int columns_samples(const char* file_name, int variant, int scenario, vector <float>* samples){
+
+    size_t size;
+    const char* data= columns_map(file_name, &size, "Columns");
+    if(data == NULL)    return 0;
+
+    const columns_header_t* h= (const columns_header_t*) data;
+    const double* values= (const double*) (data + h->data_offset);
+
+    samples->clear();
+    for(long long first=0; first<h->n_rows; first+=h->block_rows){
+        const double* block= values + first * h->n_columns;   //columns of the block are contiguous
+        const double* v= block + 2 * h->block_rows;
+        const double* k= block + 3 * h->block_rows;
+        const double* t= block + 5 * h->block_rows;
+        int rows= (h->n_rows - first < h->block_rows)?  h->n_rows - first : h->block_rows;
+        for(int i=0; i<rows; ++i)   if(v[i] == variant && k[i] == scenario) samples->push_back(t[i]);
+    }
+
+    munmap((void*) data, size);
+    return 1;
+}
+
+/**
+ * Export the columnar file: baron export results.bin [results.csv] (default: standard output)
+*/
+int run_export(int argc, char* argv[]){
+
+    if(argc < 1){
+        printf("Usage: export results.bin [results.csv]\n");
+        return 1;
+    }
+
+    size_t size;
+    const char* data= columns_map(argv[0], &size, "Export");
+    if(data == NULL)    return 1;
+
+    const columns_header_t* h= (const columns_header_t*) data;
+
+    FILE* write= (argc > 1)?  fopen(argv[1], "w") : stdout;
+    if(write == NULL){
+        printf("Export - can not open %s\n", argv[1]);
+        return 1;
+    }
+
+    const char* names= data + sizeof(columns_header_t);
+    const double* values= (const double*) (data + h->data_offset);
+
+    for(int c=0; c<(int) h->n_columns; ++c)   fprintf(write, "%s%.*s", (c)?  ";" : "", COLUMNS_NAME_SIZE, names + c * COLUMNS_NAME_SIZE);
+    fprintf(write, "\n");
+
+    for(long long i=0; i<h->n_rows; ++i){
+        const double* block= values + (i / h->block_rows) * h->block_rows * h->n_columns;
+        for(int c=0; c<(int) h->n_columns; ++c){
+            double v= block[c * h->block_rows + i % h->block_rows];
+            if(v == (long long) v)  fprintf(write, "%s%lld", (c)?  ";" : "", (long long) v);  //round, seed, variant...
+            else    fprintf(write, "%s%.9g", (c)?  ";" : "", v);
+        }
+        fprintf(write, "\n");
+    }
+
+    if(write != stdout) fclose(write);
+    munmap((void*) data, size);
+    return 0;
+}
+
+#endif  /*COLUMNS_H*/
@@ -0,0 +1,342 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file defines the configuration of a simulation campaign and the parsing of the command line options.
+        The default values reproduce the original hard-coded scenario (BARON handover under FBS attack, 1001 rounds per case).
+*/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "propagation.cpp"
+
+using namespace std;
+
+typedef struct{
+
+    int handover_version;   //defines the handover scenario: 0= standard; 1= patched
+    int is_attacker;    //defines if there is the attacker: 0 = No ; 1 = Yes
+    int n_rounds;   //number of simulation runs we want for each case scenario
+    int seed;   //seed of the random generator -> for replicability of results
+    int paired; //1 -> each round geometry is shared by the standard, BARON and BARON + attack handovers
+    double ci_width;    //if > 0, width (s) of the median confidence interval at which each case scenario stops -> n_rounds becomes the maximum
+    double confidence;  //confidence level of the median confidence interval
+    int stratified; //1 -> the UE placement is drawn from the regions producing the case scenarios that still need samples
+    char checkpoint_file[256];  //file for the periodic checkpoints of the campaign -> empty = no checkpoint
+    int checkpoint_every;   //number of rounds between two checkpoints
+    int resume; //1 -> continue the campaign from @checkpoint_file
+    char sweep_file[256];   //grid file of the parameter sweep -> empty = no sweep
+    char sweep_out[256];    //consolidated results of the parameter sweep
+    int lhs;    //number of Latin hypercube points for the ranges of the sweep
+    int n_threads;  //number of worker threads -> 0 = number of cores
+    int shard_index;    //index of the shard simulated by this process
+    int shard_count;    //number of shards of the campaign -> 0 = no sharding
+    long long total_rounds; //size of the round index space split among the shards
+    char partial_file[256]; //partial result of the shard
+    char trace_file[256];   //binary trace of the simulated rounds -> empty = no trace
+    int tsc;    //1 -> message handling times measured with the TSC instead of steady_clock
+    int profile;    //1 -> per-step timing profile reported at the end of the run
+    char profile_file[256]; //per-step profile written also in this file -> empty = only printed
+    char pin_cpus[256]; //cores to which the simulation threads are pinned -> empty = no pinning
+    int warmup; //rounds simulated before the campaign and discarded
+    int repeat; //executions of each handle_message: K-1 on cloned state + the real one
+    int repeat_median;  //1 -> handling time = median of the executions; 0 -> minimum
+    int alloc;  //1 -> allocations and leaks per round and per message type (build with -DALLOC_TRACKING)
+    int perf;   //1 -> hardware counters (perf_event_open) of each handle_message, per message type
+    char cost_file[256];    //cost profile (benchmark JSON) of the modeled-cost mode -> empty = handling times from the clock
+    double cost_scale;  //scale factor of the modeled costs (target hardware)
+    char columns_file[256]; //binary columnar file with a row per simulated round -> empty = no file
+    int columns_direct; //1 -> columnar file written with O_DIRECT
+    int quantiles;  //1 -> p50/p90/p99/p99.9 of each case scenario
+    int bootstrap;  //bootstrap resamples for the CIs of the quantiles -> 0 = no CI
+    double sketch_error;    //normalized rank error of the streaming quantile sketch -> 0 = exact (every sample stored)
+    char chrome_file[256];  //Chrome trace-event JSON of the sampled rounds -> empty = no export
+    long long chrome_every; //one sampled round every chrome_every round indices
+    int chrome_rounds;  //sampled rounds kept per thread (ring buffer)
+    int pathloss;   //path loss model of the beacons (pathloss_t) -> free space = original simulation
+    double pathloss_exp;    //path loss exponent of the log-distance model
+    double carrier; //carrier frequency (GHz) of the 3GPP models
+    double shadowing;   //standard deviation (dB) of the log-normal shadowing -> 0 = no shadowing
+    double shadow_corr; //decorrelation distance (m) of the shadow maps
+
+}config_t;
+
+
+/**
+ * Set the default configuration -> same scenario as the original simulation
+*/
+void default_config(config_t* cfg){
+
+    cfg->handover_version= 1;
+    cfg->is_attacker= 1;
+    cfg->n_rounds= 1001;
+    cfg->seed= 10;
+    cfg->paired= 0;
+    cfg->ci_width= 0.0;
+    cfg->confidence= 0.95;
+    cfg->stratified= 0;
+    cfg->checkpoint_file[0]= '\0';
+    cfg->checkpoint_every= 10000;
+    cfg->resume= 0;
+    cfg->sweep_file[0]= '\0';
+    strcpy(cfg->sweep_out, "sweep_results.xls");
+    cfg->lhs= 0;
+    cfg->n_threads= 0;
+    cfg->shard_index= 0;
+    cfg->shard_count= 0;
+    cfg->total_rounds= 0;
+    cfg->partial_file[0]= '\0';
+    cfg->trace_file[0]= '\0';
+    cfg->tsc= 0;
+    cfg->profile= 0;
+    cfg->profile_file[0]= '\0';
+    cfg->pin_cpus[0]= '\0';
+    cfg->warmup= 0;
+    cfg->repeat= 1;
+    cfg->repeat_median= 0;
+    cfg->perf= 0;
+    cfg->alloc= 0;
+    cfg->cost_file[0]= '\0';
+    cfg->cost_scale= 1.0;
+    cfg->columns_file[0]= '\0';
+    cfg->columns_direct= 0;
+    cfg->quantiles= 0;
+    cfg->bootstrap= 1000;
+    cfg->sketch_error= 0.0;
+    cfg->chrome_file[0]= '\0';
+    cfg->chrome_every= 100;
+    cfg->chrome_rounds= 64;
+    cfg->pathloss= PATHLOSS_FREE;
+    cfg->pathloss_exp= 3.0;
+    cfg->carrier= 3.5;
+    cfg->shadowing= 0.0;
+    cfg->shadow_corr= 50.0;
+}
+
+void print_usage(const char* name){
+
+    printf("Usage: %s [options]\n", name);
+    printf("  --standard        standard handover (no BARON)\n");
+    printf("  --patched         BARON handover (default)\n");
+    printf("  --attacker        FBS attack in place (default)\n");
+    printf("  --no-attacker     no FBS attack\n");
+    printf("  --rounds N        number of samples for each case scenario (default 1001)\n");
+    printf("  --seed S          seed of the random generator (default 10)\n");
+    printf("  --paired          run standard, BARON and BARON + attack on the same round geometry\n");
+    printf("  --ci-width W      stop each case scenario when the CI of its median is narrower than W seconds\n");
+    printf("                    (--rounds becomes the maximum number of samples)\n");
+    printf("  --confidence C    confidence level of the median CI and of the paired difference (default 0.95)\n");
+    printf("  --stratified      draw the UE placement directly in the regions of the case scenarios still needing samples\n");
+    printf("  --checkpoint F    periodically save the campaign state in the file F\n");
+    printf("  --checkpoint-every N  number of rounds between two checkpoints (default 10000)\n");
+    printf("  --resume          continue the campaign from the checkpoint file\n");
+    printf("  --sweep F         run the parameter sweep described by the grid file F\n");
+    printf("  --sweep-out F     consolidated results of the sweep (default sweep_results.xls)\n");
+    printf("  --lhs N           number of Latin hypercube points for the ranges of the sweep\n");
+    printf("  --threads N       number of worker threads (default: number of cores)\n");
+    printf("  --shard I/N       simulate the shard I (0-based) of N of the round index space\n");
+    printf("  --total-rounds R  size of the round index space split among the shards\n");
+    printf("  --partial-out F   partial result of the shard (default partial_I.bin)\n");
+    printf("  --columns F       write a row per simulated round (times per message type, outcome...) in the binary columnar file F\n");
+    printf("  --columns-direct  write the columnar file with O_DIRECT (bypass the page cache)\n");
+    printf("  --quantiles       report p50/p90/p99/p99.9 of each case scenario with bootstrap CIs (level --confidence)\n");
+    printf("  --bootstrap B     bootstrap resamples for the CIs of the quantiles, on --threads threads (default 1000, 0 = no CI)\n");
+    printf("  --sketch EPS      streaming mean/variance and quantile sketch (rank error EPS) instead of storing the samples\n");
+    printf("  --timer T         clock for the handling times: steady (default) or tsc\n");
+    printf("  --pin CPUS        pin the simulation threads to the cores CPUS (e.g. 2,3 or 4-7)\n");
+    printf("  --warmup N        simulate N rounds before the campaign and discard them\n");
+    printf("  --repeat K        time each handle_message K times (K-1 on cloned state)\n");
+    printf("  --repeat-stat S   handling time out of the K executions: min (default) or median\n");
+    printf("  --profile         report p50/p90/p99 and share of time of each handover step\n");
+    printf("  --profile-out F   write the per-step profile also in the file F\n");
+    printf("  --cost-model F    processing time of each step from the cost profile F (written by bench) instead of a clock\n");
+    printf("  --cost-scale S    scale factor of the modeled costs (default 1)\n");
+    printf("  --perf            hardware counters (cycles, instructions, misses, page faults) per message type\n");
+    printf("  --alloc           allocations, bytes and leaks per round and per message type (build with -DALLOC_TRACKING)\n");
+    printf("  --trace F         record seed, geometry and messages of every simulated round in the binary file F\n");
+    printf("  --chrome-trace F  write sampled rounds in the Chrome trace-event JSON F (chrome://tracing, Perfetto)\n");
+    printf("  --chrome-every N  sample one round every N round indices (default 100)\n");
+    printf("  --chrome-rounds R sampled rounds kept per thread, the most recent ones (default 64)\n");
+    printf("  --pathloss M      path loss model of the beacons: free (default), logdist, uma-los, uma-nlos, umi-los, umi-nlos\n");
+    printf("  --pathloss-exp N  path loss exponent of the log-distance model (default 3)\n");
+    printf("  --carrier F       carrier frequency (GHz) of the 3GPP models (default 3.5)\n");
+    printf("  --shadowing S     log-normal shadowing with standard deviation S dB (3GPP: 4 LOS, 6 UMa NLOS, 7.82 UMi NLOS)\n");
+    printf("  --shadow-corr D   decorrelation distance (m) of the shadowing (default 50)\n");
+    printf("Merge of the shards: %s merge partial_0.bin ... partial_N-1.bin\n", name);
+    printf("Replay of a traced round: %s replay trace.bin [ROUND [REPEAT]]\n", name);
+    printf("CSV export of the columnar file: %s export results.bin [results.csv]\n", name);
+}
+
+/**
+ * Copy the string option @value into the buffer @dest of @size bytes
+*/
+void copy_option(char* dest, const char* value, int size){
+
+    strncpy(dest, value, size-1);
+    dest[size-1]= '\0';
+}
+
+/**
+ * Parse the command line options into @cfg.
+ * Return 0 in case of an invalid option, 1 otherwise.
+*/
+int parse_arguments(int argc, char* argv[], config_t* cfg){
+
+    for(int i=1; i<argc; ++i){
+
+        if(!strcmp(argv[i], "--standard"))  cfg->handover_version= 0;
+        else if(!strcmp(argv[i], "--patched"))  cfg->handover_version= 1;
+        else if(!strcmp(argv[i], "--attacker")) cfg->is_attacker= 1;
+        else if(!strcmp(argv[i], "--no-attacker"))  cfg->is_attacker= 0;
+        else if(!strcmp(argv[i], "--paired"))   cfg->paired= 1;
+        else if(!strcmp(argv[i], "--stratified"))   cfg->stratified= 1;
+        else if(!strcmp(argv[i], "--rounds") && i+1 < argc)  cfg->n_rounds= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--seed") && i+1 < argc)    cfg->seed= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--resume"))   cfg->resume= 1;
+        else if(!strcmp(argv[i], "--checkpoint") && i+1 < argc) copy_option(cfg->checkpoint_file, argv[++i], sizeof(cfg->checkpoint_file));
+        else if(!strcmp(argv[i], "--checkpoint-every") && i+1 < argc)  cfg->checkpoint_every= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--sweep") && i+1 < argc)  copy_option(cfg->sweep_file, argv[++i], sizeof(cfg->sweep_file));
+        else if(!strcmp(argv[i], "--sweep-out") && i+1 < argc)  copy_option(cfg->sweep_out, argv[++i], sizeof(cfg->sweep_out));
+        else if(!strcmp(argv[i], "--lhs") && i+1 < argc)    cfg->lhs= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--threads") && i+1 < argc)    cfg->n_threads= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--shard") && i+1 < argc && sscanf(argv[i+1], "%d/%d", &cfg->shard_index, &cfg->shard_count) == 2) ++i;
+        else if(!strcmp(argv[i], "--total-rounds") && i+1 < argc)   cfg->total_rounds= atoll(argv[++i]);
+        else if(!strcmp(argv[i], "--partial-out") && i+1 < argc)    copy_option(cfg->partial_file, argv[++i], sizeof(cfg->partial_file));
+        else if(!strcmp(argv[i], "--timer") && i+1 < argc && !strcmp(argv[i+1], "steady"))  {cfg->tsc= 0; ++i;}
+        else if(!strcmp(argv[i], "--timer") && i+1 < argc && !strcmp(argv[i+1], "tsc"))     {cfg->tsc= 1; ++i;}
+        else if(!strcmp(argv[i], "--pin") && i+1 < argc)    copy_option(cfg->pin_cpus, argv[++i], sizeof(cfg->pin_cpus));
+        else if(!strcmp(argv[i], "--warmup") && i+1 < argc) cfg->warmup= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat") && i+1 < argc) cfg->repeat= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat-stat") && i+1 < argc && !strcmp(argv[i+1], "min"))  {cfg->repeat_median= 0; ++i;}
+        else if(!strcmp(argv[i], "--repeat-stat") && i+1 < argc && !strcmp(argv[i+1], "median"))   {cfg->repeat_median= 1; ++i;}
+        else if(!strcmp(argv[i], "--profile"))  cfg->profile= 1;
+        else if(!strcmp(argv[i], "--profile-out") && i+1 < argc)   {copy_option(cfg->profile_file, argv[++i], sizeof(cfg->profile_file)); cfg->profile= 1;}
+        else if(!strcmp(argv[i], "--cost-model") && i+1 < argc) copy_option(cfg->cost_file, argv[++i], sizeof(cfg->cost_file));
+        else if(!strcmp(argv[i], "--cost-scale") && i+1 < argc) cfg->cost_scale= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--perf")) cfg->perf= 1;
+        else if(!strcmp(argv[i], "--alloc"))    cfg->alloc= 1;
+        else if(!strcmp(argv[i], "--trace") && i+1 < argc)  copy_option(cfg->trace_file, argv[++i], sizeof(cfg->trace_file));
+        else if(!strcmp(argv[i], "--columns") && i+1 < argc)    copy_option(cfg->columns_file, argv[++i], sizeof(cfg->columns_file));
+        else if(!strcmp(argv[i], "--columns-direct"))   cfg->columns_direct= 1;
+        else if(!strcmp(argv[i], "--quantiles"))    cfg->quantiles= 1;
+        else if(!strcmp(argv[i], "--bootstrap") && i+1 < argc)  {cfg->bootstrap= atoi(argv[++i]); cfg->quantiles= 1;}
+        else if(!strcmp(argv[i], "--sketch") && i+1 < argc)  cfg->sketch_error= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--chrome-trace") && i+1 < argc)   copy_option(cfg->chrome_file, argv[++i], sizeof(cfg->chrome_file));
+        else if(!strcmp(argv[i], "--chrome-every") && i+1 < argc)   cfg->chrome_every= atoll(argv[++i]);
+        else if(!strcmp(argv[i], "--chrome-rounds") && i+1 < argc)  cfg->chrome_rounds= atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--pathloss") && i+1 < argc && pathloss_model(argv[i+1]) >= 0)    cfg->pathloss= pathloss_model(argv[++i]);
+        else if(!strcmp(argv[i], "--pathloss-exp") && i+1 < argc)   cfg->pathloss_exp= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--carrier") && i+1 < argc)    cfg->carrier= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--shadowing") && i+1 < argc)  cfg->shadowing= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--shadow-corr") && i+1 < argc)    cfg->shadow_corr= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--ci-width") && i+1 < argc)    cfg->ci_width= atof(argv[++i]);
+        else if(!strcmp(argv[i], "--confidence") && i+1 < argc)  cfg->confidence= atof(argv[++i]);
+        else{
+            printf("Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+
+    if(cfg->n_rounds <= 0){
+        printf("The number of rounds must be positive\n");
+        return 0;
+    }
+
+    if(cfg->checkpoint_every <= 0){
+        printf("The checkpoint interval must be positive\n");
+        return 0;
+    }
+
+    if(cfg->resume && !cfg->checkpoint_file[0]){
+        printf("--resume needs the checkpoint file (--checkpoint)\n");
+        return 0;
+    }
+
+    if(cfg->confidence <= 0.0 || cfg->confidence >= 1.0){
+        printf("The confidence level must be in (0, 1)\n");
+        return 0;
+    }
+
+    if(cfg->cost_scale <= 0){
+        printf("The scale of the modeled costs must be positive\n");
+        return 0;
+    }
+
+    if(cfg->repeat <= 0 || cfg->warmup < 0){
+        printf("The number of executions and of warm-up rounds must be positive\n");
+        return 0;
+    }
+
+    if(cfg->bootstrap < 0){
+        printf("The number of bootstrap resamples must be positive\n");
+        return 0;
+    }
+
+    if(cfg->sketch_error < 0.0 || cfg->sketch_error >= 0.5){
+        printf("The rank error of the sketch must be in [0, 0.5), 0 = exact\n");
+        return 0;
+    }
+
+    if(cfg->sketch_error > 0 && (cfg->paired || cfg->ci_width > 0 || cfg->stratified || cfg->sweep_file[0] || cfg->shard_count || cfg->checkpoint_file[0])){
+        printf("--sketch supports only the fixed-size campaigns without checkpoint\n");
+        return 0;
+    }
+
+    if(cfg->chrome_every <= 0 || cfg->chrome_rounds <= 0){
+        printf("The sampling period and the sampled rounds of the Chrome trace must be positive\n");
+        return 0;
+    }
+
+    if(cfg->columns_file[0] && cfg->sweep_file[0]){
+        printf("--columns is not supported by the sweep\n");
+        return 0;
+    }
+
+    if(cfg->checkpoint_file[0] && cfg->sweep_file[0]){
+        printf("--checkpoint is not supported by the sweep\n");
+        return 0;
+    }
+
+    if(cfg->trace_file[0] && cfg->sweep_file[0]){
+        printf("--trace is not supported by the sweep: the rounds are replayed on the default topology\n");
+        return 0;
+    }
+
+    if(cfg->pathloss_exp <= 0 || cfg->carrier <= 0 || cfg->shadowing < 0 || cfg->shadow_corr <= 0){
+        printf("The path loss exponent, the carrier frequency, the shadowing and its decorrelation distance must be positive\n");
+        return 0;
+    }
+
+    if(cfg->trace_file[0] && (cfg->pathloss != PATHLOSS_FREE || cfg->shadowing > 0)){
+        printf("--trace is not supported with --pathloss and --shadowing: the rounds are replayed on the default topology\n");
+        return 0;
+    }
+
+    if(cfg->shard_count){
+        if(cfg->shard_count < 0 || cfg->shard_index < 0 || cfg->shard_index >= cfg->shard_count){
+            printf("Invalid shard: %d/%d\n", cfg->shard_index, cfg->shard_count);
+            return 0;
+        }
+        if(cfg->total_rounds < cfg->shard_count){
+            printf("--shard needs the size of the round index space (--total-rounds)\n");
+            return 0;
+        }
+        if(cfg->paired || cfg->ci_width > 0 || cfg->stratified || cfg->sweep_file[0]){
+            printf("--shard supports only the fixed-size campaigns\n");
+            return 0;
+        }
+        if(!cfg->partial_file[0])   sprintf(cfg->partial_file, "partial_%d.bin", cfg->shard_index);
+    }
+
+    return 1;
+}
+
+#endif  /*CONFIG_H*/
@@ -0,0 +1,157 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the modeled-cost mode: the processing time of each protocol step is taken from a cost
+        profile instead of a clock. The profile is the JSON written by the micro-benchmarks (bench.cpp): the cost of
+        a step is the median of its case, multiplied by a scale factor to project the costs on a slower (> 1) or
+        faster (< 1) target hardware.
+        Campaigns in this mode do not read any clock, so they run at full speed and their results depend only on
+        the configuration and on the profile (bit-identical across machines).
+        The standard handover under attack uses the costs of the standard handover when the profile does not have them.
+*/
+
+#ifndef COSTMODEL_H
+#define COSTMODEL_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "user.cpp"
+#include "base_station.cpp"
+#include "AMF.cpp"
+#include "profile.cpp"
+
+using namespace std;
+
+typedef struct{
+
+    const char* name;   //name of the case: entity/message type
+    int kind;   //PROFILE_UE, PROFILE_BS, PROFILE_RBS or PROFILE_AMF
+    msg_type_t msg_type;   //message handled -> for the UE Measurement Report: message transmitted
+
+}step_case_t;
+
+const int N_STEP_CASES= 19;
+const step_case_t STEP_CASES[N_STEP_CASES]= {
+    {"UE/MR", PROFILE_UE, MSG_MEASUREMENT_REPORT},  //user::transmit_message
+    {"BS/MS_REP", PROFILE_BS, MSG_MEASUREMENT_REPORT},
+    {"BS/HO_REQ", PROFILE_BS, MSG_HANDOVER_REQUEST},
+    {"BS/HO_COM", PROFILE_BS, MSG_HANDOVER_COMMAND},
+    {"BS/RACH", PROFILE_BS, MSG_RACH},
+    {"BS/REC_REC", PROFILE_BS, MSG_RECONNECTION},
+    {"AMF/HO_RQED", PROFILE_AMF, MSG_HANDOVER_REQUIRED},
+    {"AMF/HO_ACK", PROFILE_AMF, MSG_HANDOVER_ACK},
+    {"AMF/HO_REST", PROFILE_AMF, MSG_HANDOVER_REQUEST},
+    {"AMF/REC", PROFILE_AMF, MSG_RECONNECTION},
+    {"UE/HC", PROFILE_UE, MSG_HANDOVER_COMMAND},
+    {"UE/RO", PROFILE_UE, MSG_RACH_OK},
+    {"UE/REC_OK", PROFILE_UE, MSG_RECONNECTION_OK},
+    //steps needed by the cost model to cover whole rounds
+    {"UE/REC_REJ", PROFILE_UE, MSG_RECONNECTION_REJECTED},
+    {"BS/REC_REC_OK", PROFILE_BS, MSG_RECONNECTION_OK},
+    {"BS/REC_REC_REJ", PROFILE_BS, MSG_RECONNECTION_REJECTED},
+    {"rBS/RACH", PROFILE_RBS, MSG_RACH},
+    {"AMF/RECON_OK", PROFILE_AMF, MSG_RECONNECTION_OK},
+    {"AMF/RECON_REJ", PROFILE_AMF, MSG_RECONNECTION_REJECTED}
+};
+
+int cost_enabled= 0;
+double cost_table[PROFILE_N_KEYS];  //cost (s) of each step -> < 0 = not in the profile
+int cost_missing[PROFILE_N_KEYS];   //1 -> the missing step has already been reported
+
+
+/**
+ * Return the case of the step handled (or transmitted, if @transmit) by the entity @kind for the message @msg_type,
+ * -1 if there is no case
+*/
+int step_case(int kind, msg_type_t msg_type, int transmit){
+
+    for(int c=0; c<N_STEP_CASES; ++c){
+        if(transmit != (c == 0))    continue;
+        if(STEP_CASES[c].kind == kind && STEP_CASES[c].msg_type == msg_type)   return c;
+    }
+    return -1;
+}
+
+/**
+ * Parse a case line of the benchmark JSON. Return 0 if @line is not a case
+*/
+int parse_step_line(const char* line, char* name, char* variant, int* samples, double* median, double* min, double* p90){
+
+    return sscanf(line, " {\"name\": \"%63[^\"]\", \"variant\": \"%31[^\"]\", \"samples\": %d, \"median_ns\": %lf, \"min_ns\": %lf, \"p90_ns\": %lf",
+                  name, variant, samples, median, min, p90) == 6;
+}
+
+/**
+ * Load the cost profile @file_name with the scale factor @scale. Return 0 in case of error
+*/
+int load_cost_model(const char* file_name, double scale){
+
+    FILE* f= fopen(file_name, "r");
+    if(f == NULL){
+        printf("Cost model - can not open %s\n", file_name);
+        return 0;
+    }
+
+    for(int k=0; k<PROFILE_N_KEYS; ++k){
+        cost_table[k]= -1.0;
+        cost_missing[k]= 0;
+    }
+
+    int n= 0;
+    char line[512];
+    while(fgets(line, sizeof(line), f) != NULL){
+        char name[64], variant[32];
+        int samples;
+        double median, min, p90;
+        if(!parse_step_line(line, name, variant, &samples, &median, &min, &p90))   continue;
+
+        int c= 0;
+        while(c < N_STEP_CASES && strcmp(STEP_CASES[c].name, name)) c++;
+        int v= 0;
+        while(v < PROFILE_N_VARIANTS && strcmp(PROFILE_VARIANTS[v], variant))  v++;
+        if(c == 0 || c == N_STEP_CASES || v == PROFILE_N_VARIANTS) continue;   //the transmission of the Measurement Report is not timed
+
+        cost_table[profile_key(v % 2, v / 2, STEP_CASES[c].kind, STEP_CASES[c].msg_type)]= median * 1e-9 * scale;
+        n++;
+    }
+
+    fclose(f);
+
+    if(n == 0){
+        printf("Cost model - %s has no step costs\n", file_name);
+        return 0;
+    }
+
+    //standard handover under attack -> costs of the standard handover
+    for(int kind=0; kind<PROFILE_N_KINDS; ++kind){
+        for(int step=0; step<PROFILE_N_STEPS; ++step){
+            int key= profile_key(0, 1, kind, step);
+            if(cost_table[key] < 0) cost_table[key]= cost_table[profile_key(0, 0, kind, step)];
+        }
+    }
+
+    cost_enabled= 1;
+    printf("Cost model: %d step costs from %s, scale %g\n\n", n, file_name, scale);
+    return 1;
+}
+
+/**
+ * Return the modeled cost (s) of the step @step of the entity @kind in the handover variant @handover_version/@is_attacker
+*/
+double step_cost(int handover_version, int is_attacker, int kind, int step){
+
+    int key= profile_key(handover_version, is_attacker, kind, step);
+    if(cost_table[key] >= 0)    return cost_table[key];
+
+    if(!cost_missing[key]){ //reported once -> the step costs 0
+        cost_missing[key]= 1;
+        printf("Cost model - no cost for %s %s in %s\n", PROFILE_KINDS[kind], trace_msg_name(step), PROFILE_VARIANTS[handover_version + 2*is_attacker]);
+    }
+    return 0.0;
+}
+
+#endif  /*COSTMODEL_H*/
@@ -23,307 +23,449 @@
 #include "AMF.cpp"
 #include "Utility.cpp"
 #include "message.cpp"
+#include "config.cpp"
+#include "simulation.cpp"
+#include "stopping.cpp"
+#include "sampler.cpp"
+#include "checkpoint.cpp"
+#include "campaign.cpp"
+#include "sweep.cpp"
+#include "shard.cpp"
+#include "replay.cpp"
+#include "sketch.cpp"
+#include "statistics.cpp"
+#include "columns.cpp"
 
 using namespace std;
 using namespace chrono;
 
-int main(){
 
-    srand(10);  //for replicability of results
+/**
+ * Restore the campaign state (round counter, simulated and rejected rounds and buckets) from the checkpoint when --resume
+ * is given. Return 0 if the campaign can not be resumed.
+*/
+int resume_campaign(config_t* cfg, long long* round, long long* simulated, long long* rejected, bucket_t* buckets[], int n_buckets){
 
-    // DEFINITIONS FOR WRITING IN FILES THE RESULTS
-/*  
-    // Used when simulation of standard handover
+    *round= 0;
+    *simulated= 0;
+    *rejected= 0;
+    if(!cfg->resume)    return 1;
+
+    if(!load_checkpoint(cfg->checkpoint_file, config_hash(cfg), round, simulated, rejected, buckets, n_buckets))  return 0;
 
-    char nameFile1_std[]= "results1_std.xls";   //name of file for printing results
-    FILE* write1= fopen(nameFile1_std, "w");    //open the file in writing mode
+    printf("RESUMED FROM %s AT ROUND %lld\n\n", cfg->checkpoint_file, *round);
+    return 1;
+}
 
-    char nameFile2_std[]= "results2_std.xls";   //name of file for printing results
-    FILE* write2= fopen(nameFile2_std, "w");    //open the file in writing mode
+/**
+ * Paired execution: the geometry of each round (UE position, attacker position and fake ID) is drawn once and then
+ * the standard, BARON and BARON + attack handovers are simulated on it back to back.
+ * The samples of the standard and BARON handovers are exactly matched, so the BARON overhead is also evaluated
+ * as paired difference on the same round.
 */
-/*
-    // Used when simulation of BARON but without considering the FBS attack scenario -> BARON hoverhead
+int run_paired(config_t* cfg, topology_t* topology){
 
-    char nameFile1_patch[]= "results1_patch.xls";   //name of file for printing results
-    FILE* write1= fopen(nameFile1_patch, "w");    //open the file in writing mode
+    int n_rounds= cfg->n_rounds;
 
-    char nameFile2_patch[]= "results2_patch.xls";   //name of file for printing results
-    FILE* write2= fopen(nameFile2_patch, "w");    //open the file in writing mode
-*/
-///*
+    printf("PAIRED EXECUTION: STANDARD HANDOVER - PATCHED HANDOVER - PATCHED HANDOVER WITH ATTACKER\n\n");
 
-    // Used when simulation of BARON with considering the FBS attack scenario -> BARON handover + connection recvery
+    bucket_t std_time[2];  //standard handover: [0]= tBS in sAMF; [1]= tBS NOT in sAMF
+    bucket_t patch_time[2];    //BARON handover, same rounds of @std_time
+    bucket_t diff_time[2]; //paired difference BARON - standard
+    bucket_t att_time[3];  //BARON handover under attack: [0]= tBS in sAMF; [1]= tBS NOT in sAMF; [2]= reconnection with sBS
 
-    char nameFile1_patch_att[]= "results1_patch_att.xls";   //name of file for printing results
-    FILE* write1= fopen(nameFile1_patch_att, "w");    //open the file in writing mode
+    bucket_t* all[]= {&std_time[0], &std_time[1], &patch_time[0], &patch_time[1], &diff_time[0], &diff_time[1], &att_time[0], &att_time[1], &att_time[2]};
+    for(int k=0; k<9; ++k)  init_bucket(all[k]);
 
-    char nameFile2_patch_att[]= "results2_patch_att.xls";   //name of file for printing results
-    FILE* write2= fopen(nameFile2_patch_att, "w");    //open the file in writing mode
-///*
-    char nameFile3_patch_att[]= "results3_patch_att.xls";   //name of file for printing results
-    FILE* write3= fopen(nameFile3_patch_att, "w");    //open the file in writing mode
+    long long round, simulated, rejected;
+    if(!resume_campaign(cfg, &round, &simulated, &rejected, all, 9))   return 1;
 
+    checkpointer* ckp= (cfg->checkpoint_file[0])?   new checkpointer(cfg->checkpoint_file) : NULL;
+    unsigned long long hash= config_hash(cfg);
 
-    // SCENARIO DEFINITION
+    //each variant follows the bucket and stopping rules of its fixed-size campaign (fixed_bucket, fixed_done)
+    long long n_std[3]= {0, 0, 0}, n_att[3];
+    auto std_counts= [&]() -> const long long* {for(int k=0; k<2; ++k) n_std[k]= std_time[k].samples.size(); return n_std;};
+    auto att_counts= [&]() -> const long long* {for(int k=0; k<3; ++k) n_att[k]= att_time[k].samples.size(); return n_att;};
+
+    long long j= round;
+    while(!fixed_done(std_counts(), n_rounds, 0) || !fixed_done(att_counts(), n_rounds, 1)){
+
+        j++;
+        seed_round(cfg->seed, j);   //the round is fully determined by its counter
+
+        geometry_t g;
+        generate_geometry(topology, &g, 1);   //the attacker fields are simply ignored by the variants without attacker
+
+        round_result_t r_std, r_patch, r_att;
+
+        if(!fixed_done(std_counts(), n_rounds, 0)){
+            simulate_round(topology, &g, 0, 0, &r_std);
+            simulate_round(topology, &g, 1, 0, &r_patch);
+
+            int scenario= 0;
+            if(r_patch.handover_completed != 0){
+                int k= fixed_bucket(classify_round(&r_std, 0), std_counts(), n_rounds);   //same tBS for both the variants, since same geometry
+
+                if(k >= 0){
+                    std_time[k].samples.push_back(r_std.time);
+                    patch_time[k].samples.push_back(r_patch.time);
+                    diff_time[k].samples.push_back(r_patch.time - r_std.time);
+                    scenario= k+1;
+                }
+            }
+
+            columns_add(j, cfg->seed, 0, 0, scenario, &r_std);
+            columns_add(j, cfg->seed, 1, 0, scenario, &r_patch);
+        }
+
+        if(!fixed_done(att_counts(), n_rounds, 1)){
+            simulate_round(topology, &g, 1, 1, &r_att);
+
+            int scenario= 0;
+            int k= fixed_bucket(classify_round(&r_att, 1), att_counts(), n_rounds);
+            if(k >= 0){
+                att_time[k].samples.push_back(r_att.time);
+                scenario= k+1;
+            }
+
+            columns_add(j, cfg->seed, 1, 1, scenario, &r_att);
+        }
+
+        if(ckp != NULL && j % cfg->checkpoint_every == 0){
+            ckp->save(hash, j, j, 0, all, 9);
+            trace_sync();   //the rounds up to the checkpoint reach the files -> --resume continues from them
+            columns_sync();
+        }
+    }
+
+    delete ckp; //waits for the last checkpoint to be written
+
+    printf("Rounds simulated: %lld\n\n", j);
+
+    char name[64];
+    const char* variant[]= {"std", "patch", "paired_diff"};
+    bucket_t* buckets[]= {std_time, patch_time, diff_time};
+
+    for(int v=0; v<3; ++v){
+        for(int k=0; k<2; ++k){
+            sprintf(name, "results%d_%s.xls", k+1, variant[v]);
+            FILE* write= fopen(name, "w");
+            double m= write_results(write, &buckets[v][k].samples, n_rounds);
+            fclose(write);
+
+            printf("%s - SCENARIO %d - MEDIAN: %.9f\n", variant[v], k+1, m);
+        }
+    }
+
+    for(int k=0; k<3; ++k){
+        sprintf(name, "results%d_patch_att.xls", k+1);
+        FILE* write= fopen(name, "w");
+        double m= write_results(write, &att_time[k].samples, n_rounds);
+        fclose(write);
+
+        printf("patch_att - SCENARIO %d - MEDIAN: %.9f\n", k+1, m);
+    }
 
-    vector <float> overall_time1;   //keeps the total execution time for handover when tBS is in sAMF  (in case of attack, tBS is for the reconnection)
-    vector <float> overall_time2;   //keeps the total execution time for handover when tBS is NOT in sAMF   (in case of attack, tBS is for the reconnection)
-    vector <float> overall_time3;   //keeps the total execution time for handover case under attack and reconnection with sBS 
+    //Paired difference: mean and confidence interval at the --confidence level -> the variability of the geometry is removed from the comparison
+    printf("\n");
+    for(int k=0; k<2; ++k){
+        double mean= 0.0;
+        for(int i=0; i<(int) diff_time[k].samples.size(); ++i)    mean+= diff_time[k].samples[i];
+        mean/= diff_time[k].samples.size();
+
+        if(diff_time[k].samples.size() < 2){    //no variance estimate
+            printf("SCENARIO %d - BARON OVERHEAD (PAIRED): %.9f (no CI with fewer than 2 samples)\n", k+1, mean);
+            continue;
+        }
+
+        double var= 0.0;
+        for(int i=0; i<(int) diff_time[k].samples.size(); ++i)    var+= pow(diff_time[k].samples[i] - mean, 2);
+        var/= (diff_time[k].samples.size() - 1);
+
+        printf("SCENARIO %d - BARON OVERHEAD (PAIRED): %.9f +- %.9f\n", k+1, mean, normal_quantile(cfg->confidence)*sqrt(var/diff_time[k].samples.size()));
+    }
+
+    if(cfg->quantiles){
+        const char* names[]= {"std", "std", "patch", "patch", "paired_diff", "paired_diff", "patch_att", "patch_att", "patch_att"};
+        int scenario[]= {1, 2, 1, 2, 1, 2, 1, 2, 3};
+
+        printf("\n");
+        for(int b=0; b<9; ++b){
+            sprintf(name, "%s - SCENARIO %d - QUANTILES", names[b], scenario[b]);
+            print_quantiles(name, &all[b]->samples, cfg->bootstrap, cfg->confidence, cfg->n_threads, cfg->seed);
+        }
+    }
 
-    int handover_version= 1;    //defines the handover scenario: 0= standard; 1= patched
-    int is_attacker= 1; //defines if there is the attacker: 0 = No ; 1 = Yes
-    int n_rounds= 1001; //number of simulation runs we want for each case scenario
-    int n_bs= 12 + is_attacker*1;    //number of base stations (BS) -> this comprises also the attacker
+    puts("CORRECTLY TERMINATED");
+    return 0;
+}
+
+
+/**
+ * Adaptive execution: each case scenario stops as soon as the distribution-free CI of its median is narrower than
+ * the requested width. The case scenario of a round is predicted from its geometry, so that the rounds falling in
+ * an already converged case scenario are not simulated.
+ * With stratified sampling, each round geometry is drawn directly for the case scenario with the fewest samples
+ * among those not converged, and the medians are computed on the importance weighted samples.
+*/
+int run_adaptive(config_t* cfg, topology_t* topology){
+
+    int handover_version= cfg->handover_version;
+    int is_attacker= cfg->is_attacker;
+    int n_buckets= 2 + is_attacker;
 
     if(handover_version)    printf("PATCHED HANDOVER\n");
     else    printf("STANDARD HANDOVER\n");
     if(is_attacker) printf("WITH ATTACKER\n");
     else printf("NO ATTACKER\n");
+    printf("ADAPTIVE STOPPING: CI width %.9f at confidence %.3f\n", cfg->ci_width, cfg->confidence);
+    if(cfg->stratified) printf("STRATIFIED SAMPLING\n");
     printf("\n");
 
-    int j=0;
-    while((overall_time1.size() < n_rounds || overall_time2.size() < n_rounds) && ((((int) overall_time3.size()) - 1*(1-is_attacker)) < n_rounds*is_attacker)){
-        //The condition for stopping the simulation looks at whether we have reached a certain number of simulations for each of the different scenarios define by the "overall_timeX" variables
-        
-        //printf("------------------- ROUND %d ----------------------\n", j);
-        j++;
+    campaign_t campaign;
+    init_campaign(&campaign, is_attacker);
+    bucket_t* bucket= campaign.bucket;
 
-        //---------------------------------------------- INITIALIZATION -----------------------------//
+    sampler_t sampler;
+    if(cfg->stratified){
+        init_sampler(&sampler, topology, handover_version, is_attacker);
+        for(int k=0; k<n_buckets; ++k)  printf("Scenario %d - estimated probability: %.4f\n", k+1, sampler.p_bucket[k]);
+        printf("\n");
+    }
 
-        vector <float> time; //maintains the round time simulation
+    bucket_t* all[]= {&bucket[0], &bucket[1], &bucket[2]};
+    if(!resume_campaign(cfg, &campaign.drawn, &campaign.simulated, &campaign.rejected, all, 3))   return 1;
+    count_converged(&campaign);
 
-        /*
-            Used for simulation stop condition. Its value define the result of the handover
-            - 1= handover successful
-            - 2= handover failed + reconnection recovery successful
-            - -1= handover failed + reconnection recovery rejected
-            - -2= handover failed + reconnection recovery aborted (BS failed in authentication)
-        */
-        int handover_completed= 0;
-
-        //Creation of AMFs
-        vector <AMF*> amf(2);
-        amf[0]= new AMF(1, 0, 0, n_bs, handover_version); //create the AMF-1 and the corresponding BSs are assigned under its control
-        amf[1]= new AMF(2, 2200, 1100, n_bs, handover_version); //create the AMF-2 and the corresponding BSs are assigned under its control
-        //puts("-- AMF creation OK");
-
-        //Creation of the BSs
-        vector <base_station*> bs(n_bs); //collection of base stations
-        bs[0]= new base_station(1, 200, 1000, handover_version, 0, 1, n_bs + 1);
-        bs[1]= new base_station(2, 450, 800, handover_version, 0, 1, n_bs + 1);
-        bs[2]= new base_station(3, 800, 400, handover_version, 0, 1, n_bs + 1);
-        bs[3]= new base_station(4, 1000, 50, handover_version, 0, 1, n_bs + 1);
-        bs[4]= new base_station(5, 100, 650, handover_version, 0, 1, n_bs + 1);
-        bs[5]= new base_station(6, 300, 200, handover_version, 0, 1, n_bs + 1);
-
-        bs[6]= new base_station(7, 950, 900, handover_version, 0, 2, n_bs + 2);
-        bs[7]= new base_station(8, 1250, 500, handover_version, 0, 2, n_bs + 2);
-        bs[8]= new base_station(9, 1400, 250, handover_version, 0, 2, n_bs + 2);
-        bs[9]= new base_station(10, 1200, 1100, handover_version, 0, 2, n_bs + 2);
-        bs[10]= new base_station(11, 1850, 1000, handover_version, 0, 2, n_bs + 2);
-        bs[11]= new base_station(12, 2000, 750, handover_version, 0, 2, n_bs + 2);
-        //printf("-- BSs creation OK\n");
-
-        //Creation of the UE
-        if(!handover_version && j!=1)   {random_selection(0, 2200);    random_selection(0, 1300);}  //this is to make the simulations with and without BARON to return the same user positions -> empitically discovered this relationship
-
-        user* ue= new user(12, random_selection(0, 2200), random_selection(0, 1300), handover_version, is_attacker);  //located at random position
-        
-        ue_set_connected(ue, bs, (is_attacker)? n_bs-1 : n_bs); //create the connection of the UE with sBS -> sBS is the 2nd closest BS, so to always be in case of handover needed.
-        
-        //Print some info of the UE:
-        //puts("-- UE creation OK");
-        //printf("UE - location: (%d, %d)\n", ue->get_posX(), ue->get_posY());
-        //printf("UE - connected: %d\n", ue->get_connected());
-        //printf("UE - connected AMF: %d\n\n", ue->get_AMF());
-
-        //Creation of the ATTACKER -> within ray of 150m w.r.t. UE location
-        if(is_attacker){
-            //Random selection of which legitimate BS attacker emulates -> random selection of BS_id value
-            //This fake BS_id must not be the same as the one the UE is connected to for simulation
-            int fake_id;
-            for(fake_id; (fake_id=random_selection(1,13)) == ue->get_connected(); ) {}            
-            
-            bs[12]= new base_station(fake_id, random_selection(ue->get_posX()-150, ue->get_posX()+150), random_selection(ue->get_posY()-150, ue->get_posY()+150), handover_version, 1, 0, -1);
-            
-            //Print some info of the Attacker:
-            //printf("-- ATTACKER creation OK\n");
-            //printf("ATTACKER - location: (%d, %d)\n", bs[12]->get_posX(), bs[12]->get_posY());
-            //printf("ATACKER - fake ID: %d\n\n", fake_id);
+    checkpointer* ckp= (cfg->checkpoint_file[0])?   new checkpointer(cfg->checkpoint_file) : NULL;
+    unsigned long long hash= config_hash(cfg);
+
+    while(campaign_round(cfg, topology, &sampler, &campaign)){
+        if(ckp != NULL && campaign.drawn % cfg->checkpoint_every == 0){
+            ckp->save(hash, campaign.drawn, campaign.simulated, campaign.rejected, all, 3);
+            trace_sync();
+            columns_sync();
         }
+    }
 
-        /*
-            This represents the channel sensed by the user when it has to measure beacons from other BS.
-            We avoid implementing the full and real beam sweeping and decoding process, thus we implement a high level concept of it.
-            Column 0-> signal power received
-            Column 1-> ID of corresponding BS
-        */
-        double channel[n_bs][2];
+    delete ckp; //waits for the last checkpoint to be written
 
-        /*
-            This is the channel for simulating the transmission of messages.
-            The data structure contain pointers to the exchanged message. Only one message can be in place at a time.
-            Element msg[i] != 0 -> entity [i] has received a message.
-            The correspondence is as follows:
-                - position 0 -> ue
-                - position 1 -> bs[0]
-                - position 2 -> bs[1]
-                - ....
-                - position X -> ATTACKER
-                - last position -1 -> AMF-1
-                - last postion -> AMF-2
-        */
-        message* msg[n_bs+3];        
-        for(int i=0; i<n_bs+3; ++i) msg[i]= NULL;   //declaration to NULL for protection of garbage values        
-        
-        
-        //--------------------------------------- MEASUREMENT REPORT TRANSMISSION --------------------------------//
+    printf("Rounds drawn: %lld - Rounds simulated: %lld", campaign.drawn, campaign.simulated);
+    if(cfg->stratified) printf(" - Rounds rejected: %lld", campaign.rejected);    //simulated outside the drawn case scenario
+    printf("\n\n");
 
-        transmit_beacons(channel, n_bs, ue, bs);    //populate @channel with the received power signals and corresponding BS-IDs
-        int best_bs= ue->select_best_bs(channel, n_bs); //select the best BS and target the index
-        
-        // Print the target BS
-        //printf("UE - target BS: %d\n", best_bs);
-        
-        if(ue->get_connected() != best_bs){
-            //if best BS different from the currently connected, then need handover -> by the way of how simulation implmented, this is always true
-
-            ue->set_target(best_bs);    //set the ID of the target BS
-            ue->transmit_message(msg, "Measurement Report");    //transmit the measurement report message
-
-            time.push_back(compute_delay(ue, bs[ue->get_connected()-1], 0));   //compute the transmission delay and save it. -1 because of the disallignement between BS_id and position in bs        
-
-
-            //------------------------------------ HANDOVER PROCEDURE ---------------------------------------------//
-            
-            /*
-                Defines the type of transmission = source - receiver. Used to compute the transmission delay:
-                --------> NEED TO MODIFY AND GENERALIZE
-                - 1 = ue -> BS
-                - 2 = BS -> AMF
-                - 3 = AMF <-> AMF
-                - 4 = BS <-> BS
-                - 5 = AMF -> BS
-                - 6 = BS -> UE
-            */            
-            int type_transmission= 0;   //it is set within the message handling function
-            
-            int from= 0;    //contains the index in the msg data stucture of who is the transmitter of the transmitted message
-            int to= 0;  //contains the index in the msg data stucture of who is the receiver of the transmitted message
-
-            while(handover_completed == 0){ //loop until the handover is completed
-
-                auto start= steady_clock::now();    //start the timer for comoputing the time for message handling
-
-                //handle_message -> defines how the entity should handle the arrived message, transmitting the corresponding response.
-                //the message is transmitted inside the function                                
-                if(msg[0] != NULL){
-                    ue->handle_message(msg, msg[0], channel, &handover_completed, &type_transmission);  //UE
-                    from= 0;    //UE has received the message, so it will be handle and transmit it to someone -> save as transmitter
-
-                }else if(msg[n_bs+1] != NULL){  //AMF-1
-                    amf[0]->handle_message(msg, msg[n_bs+1], &type_transmission); 
-                    from= n_bs+1;
-
-                }else if(msg[n_bs+2] != NULL){  //AMF-2
-                    amf[1]->handle_message(msg, msg[n_bs+2], &type_transmission);
-                    from= n_bs+2;
-
-                }else{   //BSs
-                    for(int i=1; i<n_bs+1; ++i){    
-                        if(msg[i] != NULL){                    
-                            bs[i-1]->handle_message(msg, msg[i], &type_transmission);    //i-1 because of the different position in the two arrays
-                            from= i;
-                        }
-                    }
-                }                
-
-                auto stop= steady_clock::now(); //stop the timer                
-                auto handling_time = std::chrono::duration_cast<std::chrono::nanoseconds>(stop-start);  //time evaluation for message handling
-                time.push_back(handling_time.count()*1e-9); //store the handling time
-
-                // Print which entity has received the message -> channel[i] != NULL
-                //for(int i=0; i<n_bs+3; ++i) printf("Channel[%d]: %p\n\n", i, msg[i]);
-
-                for(int i=0; i<n_bs+3; ++i){
-                    if(msg[i] != NULL)  to= i;  //save the reeiver
-                }
+    char name[64];
+    const char* suffix= (handover_version)?  "patch" : "std";
+    const char* suffix_att= (is_attacker)?  "_att" : "";
 
-                // Print some info about the transmition that happened
-                //printf("Type transmission: %d\n", type_transmission);
-                //printf("From: %d\nTo: %d\n", from, to);
+    for(int k=0; k<n_buckets; ++k){
+        sprintf(name, "results%d_%s%s.xls", k+1, suffix, suffix_att);
+        FILE* write= fopen(name, "w");
+        double m;
 
-                //Compute the transmission time
-                switch(type_transmission){
-                    case 1: //UE -> BS
-                        time.push_back(compute_delay(ue, bs[to-1], 0));                        
-                    break;
+        if(cfg->stratified){    //weighted samples: value;importance weight
+            vector <int> order(bucket[k].samples.size());
+            for(int i=0; i<(int) order.size(); ++i)   order[i]= i;
+            sort(order.begin(), order.end(), [&bucket, k](int a, int b){return bucket[k].samples[a] < bucket[k].samples[b];});
+            for(int i=0; i<(int) order.size(); ++i)   fprintf(write, "%.9f;%.6f\n", bucket[k].samples[order[i]], bucket[k].weights[order[i]]);
 
-                    case 2: //BS -> AMF
-                        time.push_back(compute_delay(bs[from-1], amf[to-n_bs-1], 1));                        
-                    break;
+            m= campaign_median(&campaign, k);
+        }else   m= write_results(write, &bucket[k].samples, bucket[k].samples.size());
 
-                    case 3: //AMF <-> AMF
-                        time.push_back(compute_delay(amf[0], amf[1], 1));                        
-                    break;
+        fclose(write);
 
-                    case 4: //BS <-> BS
-                        time.push_back(compute_delay(bs[from-1], bs[to-1], 1));                        
-                    break;
+        printf("SCENARIO %d - MEDIAN: %.9f - CI: [%.9f, %.9f] - SAMPLES: %d\n", k+1, m, bucket[k].ci_low, bucket[k].ci_high, (int) bucket[k].samples.size());
+    }
 
-                    case 5: //AMF -> BS
-                        time.push_back(compute_delay(bs[to-1], bs[from-n_bs-1], 1));                        
-                    break;
+    if(cfg->quantiles && !cfg->stratified){   //the quantiles of the stratified samples would need their weights
+        printf("\n");
+        for(int k=0; k<n_buckets; ++k){
+            sprintf(name, "SCENARIO %d - QUANTILES", k+1);
+            print_quantiles(name, &bucket[k].samples, cfg->bootstrap, cfg->confidence, cfg->n_threads, cfg->seed);
+        }
+    }
 
-                    case 6: //BS -> ue
-                        time.push_back(compute_delay(ue, bs[from-1], 0));                        
-                    break;
+    puts("CORRECTLY TERMINATED");
+    return 0;
+}
 
-                    default: ;
-                    break;
-                }
 
-            } //#while(!handover_completed)
-
-          
-            //Handover simulation completed. Need to sum each saved time so to define the overall handover execution time
-            /*
-            // Print which of the possible scenario happened
-            if(handover_completed==1)   printf("HANDOVER SUCCESSFUL\n\n");
-            if(handover_completed==2)   printf("HANDOVER FAILED - RECONNECTION RECOVERY SUCCESSFUL\n\n");
-            if(handover_completed==-1)  printf("HANDOVER FAILED - RECONNECTION RECOVERY REJECTED\n\n");
-            if(handover_completed==-2)  printf("HANDOVER FAILED - RECONNECTION RECOVERY ABORTED\n\n");
-            */
-
-            //compute the overall run-time execution
-            double sum= 0.0;
-            for(int i=0; i<time.size(); ++i)    sum+= time[i];
-            
-            int sBS= ue->get_connected();   //ID of the BS to which UE was connected before handover 
-            int tBS= ue->get_target();  //Id of the target BS -> in case of attack, this is the BS for reconnection
-
-            if(is_attacker){   //if attack scenario
-                if(overall_time3.size() < n_rounds && sBS == tBS)   overall_time3.push_back(sum);   //reconnection with sBS
-                else if(overall_time2.size() < n_rounds && bs[sBS-1]->get_AMF() != bs[tBS-1]->get_AMF()) overall_time2.push_back(sum);   //reconnection in tBS !in sAMF
-                else if(overall_time1.size() < n_rounds)    overall_time1.push_back(sum);   //reconnection in tBS in sAMF
-
-            }else{  //if no attack scenario
-                if( overall_time2.size() < n_rounds && bs[sBS-1]->get_AMF() != bs[tBS-1]->get_AMF() )   overall_time2.push_back(sum);   //tBS !in sAMF
-                else if(overall_time1.size() < n_rounds)    {
-                    overall_time1.push_back(sum);   //tBS in sAMF
-                }               
-            }
+int main(int argc, char* argv[]){
+
+    config_t cfg;
+    default_config(&cfg);
+    if(argc > 1 && !strcmp(argv[1], "merge"))   return run_merge(argc-2, argv+2);
+    if(argc > 1 && !strcmp(argv[1], "replay"))  return run_replay(argc-2, argv+2);
+    if(argc > 1 && !strcmp(argv[1], "export"))  return run_export(argc-2, argv+2);
+    if(!parse_arguments(argc, argv, &cfg))  return 1;
+
+    if(cfg.pin_cpus[0] && !parse_cpus(cfg.pin_cpus)){
+        printf("Invalid list of cores: %s\n", cfg.pin_cpus);
+        return 1;
+    }
+    pin_thread(0);
+    measure_repeat= cfg.repeat;
+    measure_median= cfg.repeat_median;
+
+    if(cfg.cost_file[0]){
+        if(!load_cost_model(cfg.cost_file, cfg.cost_scale))    return 1;
+    }else   timer_init((cfg.tsc)?  TIMER_TSC : TIMER_STEADY);
+
+    if(cfg.profile){
+        profile_enabled= 1;
+        strcpy(profile_file, cfg.profile_file);
+        atexit(profile_report);
+    }
+
+    if(cfg.perf){
+        perf_enabled= 1;
+        atexit(perf_report);
+    }
+
+    if(cfg.alloc){
+#ifdef ALLOC_TRACKING
+        alloc_enabled= 1;
+        atexit(alloc_report);
+#else
+        printf("--alloc needs the allocation tracker: build with -DALLOC_TRACKING\n");
+        return 1;
+#endif
+    }
+
+    long long resume_round= -1; //round of the checkpoint: the per-round outputs of the previous execution are kept up to it
+    if(cfg.resume && !checkpoint_round(cfg.checkpoint_file, config_hash(&cfg), &resume_round))  return 1;
+
+    if(cfg.trace_file[0]){
+        if(!trace_open(cfg.trace_file, resume_round))    return 1;
+        atexit(trace_close);
+    }
+
+    if(cfg.columns_file[0]){
+        if(!columns_open(cfg.columns_file, cfg.columns_direct, resume_round))   return 1;
+        atexit(columns_close);
+    }
+
+    if(cfg.chrome_file[0]){
+        chrome_enabled= 1;
+        chrome_every= cfg.chrome_every;
+        chrome_capacity= cfg.chrome_rounds;
+        strcpy(chrome_file, cfg.chrome_file);
+        atexit(chrome_export);
+    }
+
+    topology_t topology;
+    default_topology(&topology, 1.0);   //BS layout, AMF positions and transmission powers of the original simulation
+    if(cfg.pathloss != PATHLOSS_FREE || cfg.shadowing > 0) set_propagation(&topology, cfg.pathloss, cfg.pathloss_exp, cfg.carrier, cfg.shadowing, cfg.shadow_corr, cfg.seed);
+    warm_up(&topology, cfg.seed, cfg.warmup, cfg.handover_version, cfg.is_attacker, cfg.paired);
+
+    if(cfg.sweep_file[0])   return run_sweep(&cfg);
+    if(cfg.shard_count) return run_shard(&cfg, &topology);
+    if(cfg.paired)  return run_paired(&cfg, &topology);
+    if(cfg.ci_width > 0 || cfg.stratified)  return run_adaptive(&cfg, &topology);
+
+    // DEFINITIONS FOR WRITING IN FILES THE RESULTS
+    //  - standard handover: results*_std.xls
+    //  - BARON but without considering the FBS attack scenario -> BARON hoverhead: results*_patch.xls
+    //  - BARON with considering the FBS attack scenario -> BARON handover + connection recvery: results*_patch_att.xls
+
+    char nameFile1[64], nameFile2[64], nameFile3[64];
+    const char* suffix= (cfg.handover_version)?  "patch" : "std";
+    const char* suffix_att= (cfg.is_attacker)?  "_att" : "";
+
+    sprintf(nameFile1, "results1_%s%s.xls", suffix, suffix_att);   //name of file for printing results
+    FILE* write1= fopen(nameFile1, "w");    //open the file in writing mode
 
-        } //#if(measurement report)
+    sprintf(nameFile2, "results2_%s%s.xls", suffix, suffix_att);
+    FILE* write2= fopen(nameFile2, "w");
+
+    FILE* write3= NULL;
+    if(cfg.is_attacker){
+        sprintf(nameFile3, "results3_%s%s.xls", suffix, suffix_att);
+        write3= fopen(nameFile3, "w");
+    }
 
 
-        //delete the entities for memory saving        
-        delete ue;        
-        for(int i=0; i< n_bs+3; ++i)  delete msg[i];
-        for(int i=0; i<n_bs; ++i)   delete bs[i];
-        for(int i=0; i<amf.size(); ++i) delete amf[i];        
+    // SCENARIO DEFINITION
 
-    }   //#for(int j=0; j<n_rounds; ++j)
+    bucket_t bucket[3];
+    for(int k=0; k<3; ++k)  init_bucket(&bucket[k]);
+
+    //with --sketch the samples are not stored: streaming mean/variance and quantile sketch of each case scenario
+    int sketching= (cfg.sketch_error > 0);
+    stream_stat_t stream[3];
+    for(int k=0; k<3; ++k)  if(sketching)   stream_init(&stream[k], cfg.sketch_error);
+    //with --columns the samples are only counted: they are streamed to the columnar file, from which the grouped results
+    //are written at the end (not with --checkpoint, which saves the samples)
+    int streaming= cfg.columns_file[0] && !sketching && !cfg.checkpoint_file[0];
+    long long streamed[3]= {0, 0, 0};
+    auto count= [&](int k) -> long long {return (sketching)?  stream[k].moments.n : (streaming)?  streamed[k] : bucket[k].samples.size();};
+    int scenario;   //case scenario in which the round is counted -> 0 = not counted
+    auto add= [&](int k, float value){
+        if(sketching)   stream_add(&stream[k], value);
+        else if(streaming)  streamed[k]++;
+        else    bucket[k].samples.push_back(value);
+        scenario= k+1;
+    };
+
+    int handover_version= cfg.handover_version;    //defines the handover scenario: 0= standard; 1= patched
+    int is_attacker= cfg.is_attacker; //defines if there is the attacker: 0 = No ; 1 = Yes
+    int n_rounds= cfg.n_rounds; //number of simulation runs we want for each case scenario
+
+    if(handover_version)    printf("PATCHED HANDOVER\n");
+    else    printf("STANDARD HANDOVER\n");
+    if(is_attacker) printf("WITH ATTACKER\n");
+    else printf("NO ATTACKER\n");
+    printf("\n");
+
+    bucket_t* all[]= {&bucket[0], &bucket[1], &bucket[2]};
+    long long round, simulated, rejected;
+    if(!resume_campaign(&cfg, &round, &simulated, &rejected, all, 3))   return 1;
+
+    checkpointer* ckp= (cfg.checkpoint_file[0])?   new checkpointer(cfg.checkpoint_file) : NULL;
+    unsigned long long hash= config_hash(&cfg);
+
+    long long n_samples[3];
+    auto counts= [&]() -> const long long* {for(int k=0; k<3; ++k) n_samples[k]= count(k); return n_samples;};
+
+    long long j= round;
+    while(!fixed_done(counts(), n_rounds, is_attacker)){
+        //The condition for stopping the simulation looks at whether we have reached a certain number of simulations for each of the different scenarios define by the "overall_timeX" variables
+        
+        //printf("------------------- ROUND %d ----------------------\n", j);
+        j++;
+        seed_round(cfg.seed, j);    //the round is fully determined by its counter -> the simulations with and without BARON draw the same user positions
+
+        geometry_t g;
+        generate_geometry(&topology, &g, is_attacker); //UE located at random position, attacker within ray of 150m w.r.t. UE location
+
+        round_result_t r;
+        simulate_round(&topology, &g, handover_version, is_attacker, &r);
+        scenario= 0;
+
+        /*
+        // Print which of the possible scenario happened
+        if(r.handover_completed==1)   printf("HANDOVER SUCCESSFUL\n\n");
+        if(r.handover_completed==2)   printf("HANDOVER FAILED - RECONNECTION RECOVERY SUCCESSFUL\n\n");
+        if(r.handover_completed==-1)  printf("HANDOVER FAILED - RECONNECTION RECOVERY REJECTED\n\n");
+        if(r.handover_completed==-2)  printf("HANDOVER FAILED - RECONNECTION RECOVERY ABORTED\n\n");
+        */
+
+        //reconnection with sBS (attack only), tBS !in sAMF or tBS in sAMF -> a round of a full case scenario falls back to tBS in sAMF
+        int k= fixed_bucket(classify_round(&r, is_attacker), counts(), n_rounds);
+        if(k >= 0)  add(k, r.time);
+
+        columns_add(j, cfg.seed, handover_version, is_attacker, scenario, &r);
+
+        if(ckp != NULL && j % cfg.checkpoint_every == 0){
+            ckp->save(hash, j, j, 0, all, 3);
+            trace_sync();
+            columns_sync();
+        }
+
+    }   //#while(simulation)
+
+    delete ckp; //waits for the last checkpoint to be written
 
 
     //-------------------------------------TIME EXECUTION ANALYSIS ----------------------------------------//
@@ -355,67 +497,51 @@ int main(){
 
     //Group the results according to the execution time and its occurrencies. Then order the times to compute the median
 
-    //scenario 1
-    vector <stat_t> statistic1;
-    group(overall_time1, &statistic1);    //group
-    sort(&statistic1);   //sort the values
-    for(int i=0; i<statistic1.size(); ++i)  fprintf(write1, "%.9f;%d\n", statistic1[i].value, statistic1[i].occurences);
-
-    //scenario 2
-    vector <stat_t> statistic2;
-    group(overall_time2, &statistic2);    //group
-    sort(&statistic2);   //sort the values
-    for(int i=0; i<statistic2.size(); ++i)  fprintf(write2, "%.9f;%d\n", statistic2[i].value, statistic2[i].occurences);
-    
-    //scenario 3
-    vector <stat_t> statistic3;
-    if(is_attacker){        
-        group(overall_time3, &statistic3);    //group
-        sort(&statistic3);   //sort the values
-        for(int i=0; i<statistic3.size(); ++i)  fprintf(write3, "%.9f;%d\n", statistic3[i].value, statistic3[i].occurences);
-    }
-   
-    printf("\n");
-  
-    // MEDIAN VALUE
-    int mediumVal= (n_rounds-1)/2;
-    
-    //scenario 1
-    double median1= 0.0;
-    int count1= 0;
-    for(int i=0; i<statistic1.size(); ++i){
-        if(count1 + statistic1[i].occurences >= mediumVal){
-            median1= statistic1[i].value;
-            break;
+    if(sketching){  //retained values of the sketch with their weights
+        FILE* write[3]= {write1, write2, write3};
+
+        printf("\n");
+        for(int k=0; k<2+is_attacker; ++k){
+            double m= write_sketch(write[k], &stream[k]);
+            printf("SCENARIO %d - MEDIAN: %.9f - MEAN: %.9f - STD: %.9f - MIN: %.9f - MAX: %.9f (sketch of %d values)\n", k+1, m, stream[k].moments.mean,
+                    sqrt(welford_variance(&stream[k].moments)), stream[k].moments.min, stream[k].moments.max, stream[k].quantiles.retained());
         }
-        count1+= statistic1[i].occurences;
-    }
-    printf("SCENARIO 1 - MEDIAN: %.9f\n", median1);
-
-    //scenario 2
-    double median2= 0.0;
-    int count2= 0;
-    for(int i=0; i<statistic2.size(); ++i){
-        if(count2 + statistic2[i].occurences >= mediumVal){
-            median2= statistic2[i].value;
-            break;
+
+        if(cfg.quantiles){  //from the sketch -> no bootstrap
+            printf("\n");
+            for(int k=0; k<2+is_attacker; ++k){
+                printf("SCENARIO %d - QUANTILES (sketch)\n", k+1);
+                for(int i=0; i<STAT_N_QUANTILES; ++i)   printf("  %-6s %.9f\n", STAT_QUANTILE_NAMES[i], stream[k].quantiles.quantile(STAT_QUANTILES[i]));
+            }
         }
-        count2+= statistic2[i].occurences;
+
+        puts("CORRECTLY TERMINATED");
+        return 0;
     }
-    printf("SCENARIO 2 - MEDIAN: %.9f\n", median2);
 
-    if(is_attacker){
-        //scenario 3
-        double median3= 0.0;
-        int count3= 0;
-        for(int i=0; i<statistic3.size(); ++i){
-            if(count3 + statistic3[i].occurences >= mediumVal){
-                median3= statistic3[i].value;
-                break;
-            }
-            count3+= statistic3[i].occurences;
+    if(streaming)   columns_close();    //all the rows in the file
+
+    FILE* write[3]= {write1, write2, write3};
+    double median[3];
+    for(int k=0; k<2+is_attacker; ++k){
+        //streamed samples: read back one case scenario at a time (all of them for the quantiles)
+        if(streaming && !columns_samples(cfg.columns_file, handover_version + 2*is_attacker, k+1, &bucket[k].samples))  return 1;
+        median[k]= write_results(write[k], &bucket[k].samples, n_rounds);
+        if(streaming && !cfg.quantiles) vector <float>().swap(bucket[k].samples);
+    }
+   
+    printf("\n");
+    printf("SCENARIO 1 - MEDIAN: %.9f\n", median[0]);
+    printf("SCENARIO 2 - MEDIAN: %.9f\n", median[1]);
+    if(is_attacker) printf("SCENARIO 3 - MEDIAN: %.9f\n", median[2]);
+
+    if(cfg.quantiles){
+        char label[64];
+        printf("\n");
+        for(int k=0; k<2+is_attacker; ++k){
+            sprintf(label, "SCENARIO %d - QUANTILES", k+1);
+            print_quantiles(label, &bucket[k].samples, cfg.bootstrap, cfg.confidence, cfg.n_threads, cfg.seed);
         }
-        printf("SCENARIO 3 - MEDIAN: %.9f\n", median3);
     }
 
     puts("CORRECTLY TERMINATED");
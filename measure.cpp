@@ -0,0 +1,79 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the measurement mode for the message handling times:
+            - pinning of the simulation threads to a list of (isolated) cores, so that they do not migrate
+            - warm-up rounds before the campaign, so that the pages are mapped and the caches warm
+            - repeated timing: each handle_message is executed K-1 times on clones of the handling entity and of the
+              message (with the random generator restored after each execution), then for real; the handling time of
+              the round is the minimum or the median of the K executions
+*/
+
+#ifndef MEASURE_H
+#define MEASURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+vector <int> measure_cpus;  //cores for the simulation threads -> empty = no pinning
+int measure_repeat= 1;  //executions of each handle_message
+int measure_median= 0;  //1 -> median of the executions; 0 -> minimum
+
+
+/**
+ * Parse the list of cores @list ("2,3,5-7") into measure_cpus. Return 0 in case of error
+*/
+int parse_cpus(const char* list){
+
+    measure_cpus.clear();
+
+    char buffer[256];
+    strncpy(buffer, list, sizeof(buffer)-1);
+    buffer[sizeof(buffer)-1]= '\0';
+
+    for(char* token= strtok(buffer, ","); token != NULL; token= strtok(NULL, ",")){
+        int a, b;
+        int n= sscanf(token, "%d-%d", &a, &b);
+        if(n == 1)  b= a;
+        if(n < 1 || a < 0 || b < a) return 0;
+        for(int c=a; c<=b; ++c) measure_cpus.push_back(c);
+    }
+
+    return !measure_cpus.empty();
+}
+
+/**
+ * Pin the calling thread to the core of the worker @worker (round-robin over measure_cpus)
+*/
+void pin_thread(int worker){
+
+    if(measure_cpus.empty())    return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(measure_cpus[worker % measure_cpus.size()], &set);
+
+    if(sched_setaffinity(0, sizeof(set), &set) != 0)    printf("Measure - can not pin the thread to core %d\n", measure_cpus[worker % measure_cpus.size()]);
+}
+
+/**
+ * Return the handling time out of the @n executions @times -> minimum or median
+*/
+double reduce_times(double* times, int n){
+
+    if(!measure_median) return *min_element(times, times + n);
+
+    nth_element(times, times + n/2, times + n);
+    return times[n/2];
+}
+
+#endif  /*MEASURE_H*/
@@ -5,73 +5,116 @@
 
     @Description:
         This file defines the Message entity for the simulation.
-        It containes the info and functions for building messages that are exchanged between parties during the simulation. 
+        It containes the info and functions for building messages that are exchanged between parties during the simulation.
+        The message is a compact value (36 bytes): the type is an enum, the content is stored inline and the token is
+        a fixed-size array read by reference, so copying a message needs no dynamic memory.
 */
 
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
+#include <stdio.h>
 #include <string.h>
-//#include <vector>
+#include <array>
+
+using namespace std;
+
+enum msg_type_t : unsigned char {
+    MSG_MEASUREMENT_REPORT,
+    MSG_HANDOVER_REQUIRED,
+    MSG_HANDOVER_REQUEST,
+    MSG_HANDOVER_ACK,
+    MSG_HANDOVER_COMMAND,
+    MSG_RACH,
+    MSG_RACH_OK,
+    MSG_RECONNECTION,
+    MSG_RECONNECTION_OK,
+    MSG_RECONNECTION_REJECTED,
+    MSG_N_TYPES
+};
+
+const char* MSG_NAMES[MSG_N_TYPES]= {"Measurement Report", "Handover Required", "Handover Request", "Handover ACK",
+                                     "Handover Command", "RACH procedure", "RACH OK", "Reconnection Recovery",
+                                     "Reconnection Recovery OK", "Reconnection Recovery Rejected"};
+
+const int MSG_MAX_CONTENT= 4;   //largest content: Reconnection Recovery forwarded to the AMF
+const int MSG_TOKEN_SIZE= 16;   //AES-128 block
+
+typedef array <unsigned char, MSG_TOKEN_SIZE> token_t;
 
 class message{
 
     private:
-        char type[50];
-        int content[10];
-        unsigned char token[16];
-        int is_token;   //define whether the message has the token field populated
-        int n_content= 0;
+        msg_type_t type;
+        unsigned char n_content= 0;
+        unsigned char is_token;   //define whether the message has the token field populated
+        int content[MSG_MAX_CONTENT];
+        token_t token;
 
     public:
-        message(const char* msg_type, int msg_content[], int n_content);
-        message(const char* msg_type, int msg_content[], int n_content, unsigned char* tk);
+        message();  //empty slot of the message channel
+        message(msg_type_t msg_type, const int msg_content[], int n_content);
+        message(msg_type_t msg_type, const int msg_content[], int n_content, const unsigned char* tk, int tk_size= MSG_TOKEN_SIZE);   //the bytes after @tk_size are 0
+        message(msg_type_t msg_type, const int msg_content[], int n_content, const token_t& tk);
 
-        char* get_type();   //return a pointer to the type field
+        msg_type_t get_type();   //return the type
+        const char* get_name();  //return the name of the type
         int* get_content(); //return a pointer to the content field
         int get_content(int index); //return the value of content in position index
         int get_n_content();    //return the number of entries of the content field
-        unsigned char* get_token(); //return a pointer to an allocated copy of the token value
+        int has_token();    //return 1 if the token is populated
+        const token_t& get_token(); //return the token
 
         void print_type();  //print type
         void print_content();   //print content
 };
 
-message::message(const char* msg_type, int msg_content[], int n_content){
+message::message(){
+
+    type= MSG_N_TYPES;
+    is_token= 0;
+}
+
+message::message(msg_type_t msg_type, const int msg_content[], int n_content){
 
-    strcpy(type, msg_type);
+    type= msg_type;
     for(int i=0; i<n_content; ++i)  content[i]= msg_content[i];
     this->n_content= n_content;
 
     is_token= 0;
 }
 
-message::message(const char* msg_type, int msg_content[], int n_content, unsigned char* tk){
+message::message(msg_type_t msg_type, const int msg_content[], int n_content, const unsigned char* tk, int tk_size){
 
-    strcpy(type, msg_type);
+    type= msg_type;
     for(int i=0; i<n_content; ++i)  content[i]= msg_content[i];
     this->n_content= n_content;
 
-    for(int i=0; i<16; ++i) token[i]= tk[i];
+    token.fill(0);
+    for(int i=0; i<tk_size; ++i)    token[i]= tk[i];
 
     is_token= 1;
 }
 
-char* message::get_type()   {return type;}
-int* message::get_content()  {return content;}
-int message::get_content(int index) {return content[index];}
-int message::get_n_content()    {return n_content;}
-
-unsigned char* message::get_token(){
-    if(!is_token)   return NULL;    //if there is no token then return NULL
+message::message(msg_type_t msg_type, const int msg_content[], int n_content, const token_t& tk){
 
-    unsigned char* copy_token= (unsigned char*) calloc(16, 1);  //allocate the memory space
-    for(int i=0; i<16; ++i) copy_token[i]= token[i];
+    type= msg_type;
+    for(int i=0; i<n_content; ++i)  content[i]= msg_content[i];
+    this->n_content= n_content;
 
-    return copy_token;
+    token= tk;
+    is_token= 1;
 }
 
-void message::print_type()  {printf("Message type: %s\n", type);}
+msg_type_t message::get_type()  {return type;}
+const char* message::get_name() {return MSG_NAMES[type];}
+int* message::get_content()  {return content;}
+int message::get_content(int index) {return content[index];}
+int message::get_n_content()    {return n_content;}
+int message::has_token()    {return is_token;}
+const token_t& message::get_token() {return token;}
+
+void message::print_type()  {printf("Message type: %s\n", MSG_NAMES[type]);}
 void message::print_content()   {for(int i=0; i<n_content; i++) printf("Content %d: %d\n", i, content[i]);}
 
-#endif  /*MESSAGE_H*/
\ No newline at end of file
+#endif  /*MESSAGE_H*/
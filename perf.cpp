@@ -0,0 +1,211 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the optional hardware counters of the message handling (Linux perf_event_open):
+        cycles, instructions, branch misses, L1 data and last level cache read misses, page faults.
+        The counters are opened per thread as one group (read with a single system call before and after each
+        timed handle_message) and the deltas are aggregated with the same keys of the step profile
+        (entity kind, message type, handover variant).
+        Events not supported by the CPU are left out; if perf events are not permitted (perf_event_paranoid,
+        containers, other OS) the counters are disabled with a message and the simulation runs as usual.
+*/
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "profile.cpp"
+
+using namespace std;
+
+const int PERF_N_EVENTS= 6;
+const char* PERF_EVENTS[PERF_N_EVENTS]= {"cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses", "page-faults"};
+
+typedef struct{
+
+    long long count;    //number of measured handlings
+    double value[PERF_N_EVENTS];    //sum of the counter deltas
+
+}perf_stat_t;
+
+class perf_counters{
+    public:
+        int fd[PERF_N_EVENTS];  //-1 -> event not available
+        int slot[PERF_N_EVENTS];    //position of the event in the group read
+        int n_open= 0;
+        int opened= 0;  //the thread already tried to open the counters
+        unsigned long long start[PERF_N_EVENTS + 1];
+        perf_stat_t stat[PROFILE_N_KEYS];
+
+        int open(); //open the counters of the calling thread. Return 0 if not permitted
+        int read(unsigned long long* values);   //read the group into @values (nr + counters)
+        ~perf_counters();   //merge into the global counters at the exit of the thread
+};
+
+int perf_enabled= 0;
+int perf_available[PERF_N_EVENTS];  //1 -> the event could be opened by at least one thread
+perf_stat_t perf_all[PROFILE_N_KEYS];   //counters of the exited threads
+mutex perf_lock;
+thread_local perf_counters perf_tls;
+
+
+#ifdef __linux__
+/**
+ * Open the event @config of @type in the group @group_fd (-1 -> leader)
+*/
+int perf_open_event(unsigned int type, unsigned long long config, int group_fd){
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size= sizeof(attr);
+    attr.type= type;
+    attr.config= config;
+    attr.exclude_kernel= 1; //allowed with perf_event_paranoid <= 2
+    attr.exclude_hv= 1;
+    attr.read_format= PERF_FORMAT_GROUP;
+    attr.disabled= (group_fd == -1);
+
+    return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+int perf_counters::open(){
+
+    opened= 1;
+    for(int e=0; e<PERF_N_EVENTS; ++e)  fd[e]= -1;
+
+#ifdef __linux__
+    unsigned int types[PERF_N_EVENTS]= {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_SOFTWARE};
+    unsigned long long configs[PERF_N_EVENTS]= {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_SW_PAGE_FAULTS};
+
+    int leader= -1;
+    for(int e=0; e<PERF_N_EVENTS; ++e){
+        fd[e]= perf_open_event(types[e], configs[e], leader);
+        if(fd[e] < 0)   continue;   //event not supported -> left out
+
+        if(leader == -1)    leader= fd[e];
+        slot[e]= n_open++;
+    }
+
+    if(leader == -1)    return 0;
+
+    {
+        lock_guard <mutex> guard(perf_lock);
+        for(int e=0; e<PERF_N_EVENTS; ++e)  if(fd[e] >= 0) perf_available[e]= 1;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int perf_counters::read(unsigned long long* values){
+
+    for(int e=0; e<PERF_N_EVENTS; ++e){
+        if(fd[e] >= 0)  return ::read(fd[e], values, (n_open + 1) * sizeof(unsigned long long)) > 0;  //the first open event is the leader
+    }
+    return 0;
+}
+
+perf_counters::~perf_counters(){
+
+    for(int e=0; e<PERF_N_EVENTS; ++e)  if(opened && fd[e] >= 0)    close(fd[e]);
+
+    lock_guard <mutex> guard(perf_lock);
+    for(int k=0; k<PROFILE_N_KEYS; ++k){
+        perf_all[k].count+= stat[k].count;
+        for(int e=0; e<PERF_N_EVENTS; ++e)  perf_all[k].value[e]+= stat[k].value[e];
+    }
+}
+
+/**
+ * Read the counters before a timed handle_message. Return 0 if the counters are not available
+*/
+int perf_begin(){
+
+    perf_counters* p= &perf_tls;
+
+    if(!p->opened && !p->open()){
+        lock_guard <mutex> guard(perf_lock);
+        if(perf_enabled){
+            printf("Perf - hardware counters not permitted or not supported (see /proc/sys/kernel/perf_event_paranoid): disabled\n");
+            perf_enabled= 0;
+        }
+        return 0;
+    }
+
+    return p->n_open > 0 && p->read(p->start);
+}
+
+/**
+ * Read the counters after a timed handle_message and add the deltas to the step @key
+*/
+void perf_end(int key){
+
+    perf_counters* p= &perf_tls;
+    unsigned long long stop[PERF_N_EVENTS + 1];
+    if(!p->read(stop))  return;
+
+    perf_stat_t* s= &p->stat[key];
+    s->count++;
+    for(int e=0; e<PERF_N_EVENTS; ++e){
+        if(p->fd[e] >= 0)   s->value[e]+= stop[1 + p->slot[e]] - p->start[1 + p->slot[e]];
+    }
+}
+
+/**
+ * Print the average counters per handling of each step -> registered with atexit(), after the exit of all the threads
+*/
+void perf_report(){
+
+    if(!perf_enabled)   return;
+
+    for(int v=0; v<PROFILE_N_VARIANTS; ++v){
+
+        int header= 0;
+        for(int kind=0; kind<PROFILE_LINK; ++kind){
+            for(int step=0; step<PROFILE_N_STEPS; ++step){
+
+                perf_stat_t* s= &perf_all[(v * PROFILE_N_KINDS + kind) * PROFILE_N_STEPS + step];
+                if(s->count == 0)   continue;
+
+                if(!header){
+                    printf("\nHARDWARE COUNTERS (average per handling) - %s\n", PROFILE_VARIANTS[v]);
+                    printf("  %-5s %-32s %10s", "", "", "count");
+                    for(int e=0; e<PERF_N_EVENTS; ++e)  printf(" %13s", PERF_EVENTS[e]);
+                    printf(" %6s\n", "IPC");
+                    header= 1;
+                }
+
+                printf("  %-5s %-32s %10lld", PROFILE_KINDS[kind], trace_msg_name(step), s->count);
+                for(int e=0; e<PERF_N_EVENTS; ++e){
+                    if(perf_available[e])   printf(" %13.1f", s->value[e] / s->count);
+                    else    printf(" %13s", "n/a");
+                }
+                if(perf_available[0] && perf_available[1])  printf(" %6.2f\n", s->value[1] / s->value[0]);
+                else    printf(" %6s\n", "n/a");
+            }
+        }
+    }
+}
+
+#endif  /*PERF_H*/
@@ -0,0 +1,194 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the per-step timing profile of the handover.
+        Each handling time is recorded under the key (entity kind, message type, handover variant) and each
+        propagation delay under (link, type of transmission, handover variant), in log-scale histograms
+        (16 bins per octave, from 1ns). The histograms are per-thread and are merged when the threads exit.
+        At the end of the run the p50/p90/p99 of every step and its share of the total time of the variant are
+        reported, together with the difference of the p50 w.r.t. the standard handover when both are profiled.
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <mutex>
+
+#include "trace.cpp"
+
+using namespace std;
+
+const int PROFILE_UE= 0;
+const int PROFILE_BS= 1;
+const int PROFILE_RBS= 2;   //attacker
+const int PROFILE_AMF= 3;
+const int PROFILE_LINK= 4;  //propagation delay
+const int PROFILE_N_KINDS= 5;
+const char* PROFILE_KINDS[PROFILE_N_KINDS]= {"UE", "BS", "rBS", "AMF", "Link"};
+
+const int PROFILE_N_STEPS= TRACE_N_MSG_TYPES + 1;   //message types + unknown -> for the link: type of transmission
+const char* PROFILE_LINKS[7]= {"none", "UE -> BS", "BS -> AMF", "AMF <-> AMF", "BS <-> BS", "AMF -> BS", "BS -> UE"};
+
+const int PROFILE_N_VARIANTS= 4;    //handover version + 2 * attacker
+const char* PROFILE_VARIANTS[PROFILE_N_VARIANTS]= {"std", "patch", "std_att", "patch_att"};
+
+const int PROFILE_N_KEYS= PROFILE_N_VARIANTS * PROFILE_N_KINDS * PROFILE_N_STEPS;
+const int PROFILE_BINS_PER_OCTAVE= 16;
+const int PROFILE_N_BINS= PROFILE_BINS_PER_OCTAVE * 40; //1ns -> ~1000s
+
+typedef struct{
+
+    long long count= 0;
+    double sum= 0.0;    //total time (s)
+    vector <unsigned int> bins; //allocated at the first sample
+
+}histogram_t;
+
+class profile_t{
+    public:
+        histogram_t hist[PROFILE_N_KEYS];
+
+        void add(int key, double value);
+        void merge(profile_t* p);
+        ~profile_t();   //merge into the global profile at the exit of the thread
+};
+
+int profile_enabled= 0;
+char profile_file[256]= "";
+profile_t profile_all;  //histograms of the exited threads
+mutex profile_lock;
+thread_local profile_t profile_tls;
+
+
+/**
+ * Return the key of the step @step of the entity @kind in the handover variant @handover_version/@is_attacker
+*/
+inline int profile_key(int handover_version, int is_attacker, int kind, int step){
+
+    if(step < 0 || step >= PROFILE_N_STEPS) step= TRACE_N_MSG_TYPES;
+    return ((handover_version + 2*is_attacker) * PROFILE_N_KINDS + kind) * PROFILE_N_STEPS + step;
+}
+
+void profile_t::add(int key, double value){
+
+    histogram_t* h= &hist[key];
+    if(h->bins.empty()) h->bins.assign(PROFILE_N_BINS, 0);
+
+    double ns= value * 1e9;
+    int bin= (ns < 1.0)?  0 : (int) (log2(ns) * PROFILE_BINS_PER_OCTAVE);
+    if(bin >= PROFILE_N_BINS)   bin= PROFILE_N_BINS - 1;
+
+    h->bins[bin]++;
+    h->count++;
+    h->sum+= value;
+}
+
+void profile_t::merge(profile_t* p){
+
+    for(int k=0; k<PROFILE_N_KEYS; ++k){
+        histogram_t* src= &p->hist[k];
+        if(src->count == 0) continue;
+
+        histogram_t* h= &hist[k];
+        if(h->bins.empty()) h->bins.assign(PROFILE_N_BINS, 0);
+        for(int b=0; b<PROFILE_N_BINS; ++b) h->bins[b]+= src->bins[b];
+        h->count+= src->count;
+        h->sum+= src->sum;
+
+        src->count= 0;
+        src->sum= 0;
+        src->bins.clear();
+    }
+}
+
+profile_t::~profile_t(){
+
+    if(this == &profile_all)    return;
+
+    lock_guard <mutex> guard(profile_lock);
+    profile_all.merge(this);
+}
+
+/**
+ * Record the time @value (s) of a step of the round
+*/
+inline void profile_add(int handover_version, int is_attacker, int kind, int step, double value){
+
+    profile_tls.add(profile_key(handover_version, is_attacker, kind, step), value);
+}
+
+/**
+ * Return the quantile @p of the histogram @h -> geometric center of the bin
+*/
+double histogram_quantile(histogram_t* h, double p){
+
+    long long target= (long long) ceil(p * h->count);
+    if(target < 1)  target= 1;
+
+    long long count= 0;
+    for(int b=0; b<PROFILE_N_BINS; ++b){
+        count+= h->bins[b];
+        if(count >= target) return pow(2.0, (b + 0.5) / PROFILE_BINS_PER_OCTAVE) * 1e-9;
+    }
+    return 0.0;
+}
+
+/**
+ * Print (and write in @profile_file, if given) the per-step profile -> registered with atexit(), after the exit of all
+ * the threads
+*/
+void profile_report(){
+
+    FILE* write= (profile_file[0])?  fopen(profile_file, "w") : NULL;
+    if(write != NULL)   fprintf(write, "variant;entity;step;count;p50;p90;p99;share;p50_vs_std\n");
+
+    for(int v=0; v<PROFILE_N_VARIANTS; ++v){
+
+        double total= 0.0;
+        for(int k=0; k<PROFILE_N_KINDS * PROFILE_N_STEPS; ++k) total+= profile_all.hist[v * PROFILE_N_KINDS * PROFILE_N_STEPS + k].sum;
+        if(total == 0.0)    continue;
+
+        printf("\nSTEP PROFILE - %s\n", PROFILE_VARIANTS[v]);
+        printf("  %-5s %-32s %10s %10s %10s %10s %7s %12s\n", "", "", "count", "p50 (us)", "p90 (us)", "p99 (us)", "share", "vs std (us)");
+
+        for(int kind=0; kind<PROFILE_N_KINDS; ++kind){
+            for(int step=0; step<PROFILE_N_STEPS; ++step){
+
+                int key= (v * PROFILE_N_KINDS + kind) * PROFILE_N_STEPS + step;
+                histogram_t* h= &profile_all.hist[key];
+                if(h->count == 0)   continue;
+
+                const char* name= (kind == PROFILE_LINK)?  ((step < 7)?  PROFILE_LINKS[step] : "unknown") : trace_msg_name(step);
+                double p50= histogram_quantile(h, 0.50);
+                double p90= histogram_quantile(h, 0.90);
+                double p99= histogram_quantile(h, 0.99);
+                double share= h->sum / total;
+
+                //same step of the standard handover (same attacker setting)
+                histogram_t* h_std= &profile_all.hist[key - (v % 2) * PROFILE_N_KINDS * PROFILE_N_STEPS];
+                int has_std= (v % 2 == 1 && h_std->count > 0);
+                double diff= (has_std)?  p50 - histogram_quantile(h_std, 0.50) : 0.0;
+
+                printf("  %-5s %-32s %10lld %10.3f %10.3f %10.3f %6.1f%%", PROFILE_KINDS[kind], name, h->count, p50*1e6, p90*1e6, p99*1e6, share*100);
+                if(has_std) printf(" %+12.3f", diff*1e6);
+                printf("\n");
+
+                if(write != NULL){
+                    fprintf(write, "%s;%s;%s;%lld;%.9f;%.9f;%.9f;%.6f;", PROFILE_VARIANTS[v], PROFILE_KINDS[kind], name, h->count, p50, p90, p99, share);
+                    if(has_std) fprintf(write, "%.9f", diff);
+                    fprintf(write, "\n");
+                }
+            }
+        }
+    }
+
+    if(write != NULL)   fclose(write);
+}
+
+#endif  /*PROFILE_H*/
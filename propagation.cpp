@@ -0,0 +1,222 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the path loss models of the beacons received by the UE, used instead of the free-space
+        PT/d^2 of the original simulation when the campaign runs with --pathloss or --shadowing:
+            - free: free space, PT/d^2
+            - logdist: log-distance, PT/d^n with reference distance 1 m
+            - uma-los, uma-nlos, umi-los, umi-nlos: 3GPP TR 38.901 Urban Macro (BS at 25 m) and Urban Micro street
+              canyon (BS at 10 m), UE at 1.5 m, NLOS = max(LOS, NLOS formula)
+        The linear gain of the model is tabulated once every PROPAGATION_STEP meters up to the largest distance of the
+        topology and read with linear interpolation, so a round evaluates no logarithm or power.
+        Log-normal shadowing (sigma dB) comes from precomputed shadow maps: one per BS (the last one for the rBS) on a
+        grid of SHADOW_CELL meters over the UE plane, spatially correlated by a separable AR(1) filter along the rows
+        and the columns (correlation exp(-dx/D) * exp(-dy/D)), and sampled by bilinear lookup at the UE position.
+        The maps are interleaved by cell (the values of all the BSs of a grid point are contiguous), so the lookup of
+        a round reads four contiguous runs with the same weights. The maps are drawn from a private generator, so the
+        simulation random sequence is not touched.
+        The kernels run over SoA arrays of the BS positions and powers with no dependency among the BSs, so that the
+        compiler can vectorize them.
+*/
+
+#ifndef PROPAGATION_H
+#define PROPAGATION_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "statistics.cpp"
+
+using namespace std;
+
+enum pathloss_t {
+    PATHLOSS_FREE,
+    PATHLOSS_LOGDIST,
+    PATHLOSS_UMA_LOS,
+    PATHLOSS_UMA_NLOS,
+    PATHLOSS_UMI_LOS,
+    PATHLOSS_UMI_NLOS,
+    PATHLOSS_N_MODELS
+};
+
+const char* PATHLOSS_NAMES[PATHLOSS_N_MODELS]= {"free", "logdist", "uma-los", "uma-nlos", "umi-los", "umi-nlos"};
+
+const double PROPAGATION_STEP= 0.25;    //distance (m) between two entries of the gain table
+const double SHADOW_CELL= 10.0; //size (m) of a cell of the shadow maps
+const double UE_HEIGHT= 1.5;    //antenna height (m) of the UE in the 3GPP models
+
+typedef struct{
+
+    int model;  //path loss model (pathloss_t)
+    double exponent;    //path loss exponent of the log-distance model
+    double carrier; //carrier frequency (GHz) of the 3GPP models
+    double sigma;   //standard deviation (dB) of the shadowing -> 0 = no shadowing
+    double corr;    //decorrelation distance (m) of the shadowing
+
+    vector <float> gain;    //linear gain at the distance k*PROPAGATION_STEP
+    double last;    //last index of @gain at which the interpolation is valid
+
+    int n_maps; //shadow maps: one per BS, the last one for the rBS
+    int nx, ny; //grid points along the x and y axes
+    vector <float> shadow;  //linear shadowing factor of map m at the grid point (ix, iy) -> [(iy*nx + ix)*n_maps + m]
+
+}propagation_t;
+
+
+/**
+ * Return the model with the name @name, -1 if unknown
+*/
+int pathloss_model(const char* name){
+
+    for(int m=0; m<PATHLOSS_N_MODELS; ++m)  if(!strcmp(name, PATHLOSS_NAMES[m]))    return m;
+    return -1;
+}
+
+/**
+ * Path loss (dB) of the model of @p at the horizontal distance @d
+*/
+double pathloss_db(propagation_t* p, double d){
+
+    double h_bs= (p->model == PATHLOSS_UMA_LOS || p->model == PATHLOSS_UMA_NLOS)?  25.0 : 10.0;
+    double d3= sqrt(d*d + (h_bs - UE_HEIGHT) * (h_bs - UE_HEIGHT));
+    double bp= 4 * (h_bs - 1.0) * (UE_HEIGHT - 1.0) * p->carrier * 1e9 / 3e8;  //breakpoint distance (effective heights)
+    double bp_term= bp*bp + (h_bs - UE_HEIGHT) * (h_bs - UE_HEIGHT);
+    double fc= 20 * log10(p->carrier);
+
+    double los, nlos;
+    switch(p->model){
+        case PATHLOSS_FREE: return 20 * log10(d);
+        case PATHLOSS_LOGDIST:  return 10 * p->exponent * log10(d);
+
+        case PATHLOSS_UMA_LOS:
+        case PATHLOSS_UMA_NLOS:
+            los= (d <= bp)?  28.0 + 22 * log10(d3) + fc : 28.0 + 40 * log10(d3) + fc - 9 * log10(bp_term);
+            if(p->model == PATHLOSS_UMA_LOS)    return los;
+            nlos= 13.54 + 39.08 * log10(d3) + fc - 0.6 * (UE_HEIGHT - 1.5);
+            return (nlos > los)?  nlos : los;
+
+        default:
+            los= (d <= bp)?  32.4 + 21 * log10(d3) + fc : 32.4 + 40 * log10(d3) + fc - 9.5 * log10(bp_term);
+            if(p->model == PATHLOSS_UMI_LOS)    return los;
+            nlos= 22.4 + 35.3 * log10(d3) + 21.3 * log10(p->carrier) - 0.3 * (UE_HEIGHT - 1.5);
+            return (nlos > los)?  nlos : los;
+    }
+}
+
+/**
+ * Standard normal value from the generator @state (Box-Muller)
+*/
+double shadow_normal(unsigned long long* state){
+
+    double u1= ((splitmix64(state) >> 11) + 0.5) * 0x1.0p-53;
+    double u2= (splitmix64(state) >> 11) * 0x1.0p-53;
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+/**
+ * Draw in @field (@nx x @ny, row-major) a unit-variance Gaussian field with correlation @rho between adjacent grid points
+*/
+void shadow_field(double* field, int nx, int ny, double rho, unsigned long long* state){
+
+    double innovation= sqrt(1 - rho*rho);
+
+    for(int i=0; i<nx*ny; ++i)  field[i]= shadow_normal(state);
+
+    for(int y=0; y<ny; ++y){    //AR(1) along the rows
+        double* row= field + y*nx;
+        for(int x=1; x<nx; ++x) row[x]= rho * row[x-1] + innovation * row[x];
+    }
+    for(int y=1; y<ny; ++y){    //AR(1) along the columns: the rows are independent -> the variance stays 1
+        for(int x=0; x<nx; ++x) field[y*nx + x]= rho * field[(y-1)*nx + x] + innovation * field[y*nx + x];
+    }
+}
+
+/**
+ * Initialize @p for the model @model: gain table up to the distance @max_distance and, if @sigma > 0, @n_maps shadow
+ * maps over the plane @width x @height drawn from @seed
+*/
+void init_propagation(propagation_t* p, int model, double exponent, double carrier, double sigma, double corr,
+                      int width, int height, double max_distance, int n_maps, unsigned long long seed){
+
+    p->model= model;
+    p->exponent= exponent;
+    p->carrier= carrier;
+    p->sigma= sigma;
+    p->corr= corr;
+
+    double d_min= (model == PATHLOSS_FREE || model == PATHLOSS_LOGDIST)?  1.0 : 10.0;   //reference distance, 3GPP validity
+    int n= (int) ceil(max_distance / PROPAGATION_STEP) + 2;
+    p->gain.resize(n);
+    for(int k=0; k<n; ++k){
+        double d= k * PROPAGATION_STEP;
+        p->gain[k]= pow(10.0, -pathloss_db(p, (d < d_min)?  d_min : d) / 10);
+    }
+    p->last= n - 1.000001;
+
+    p->n_maps= n_maps;
+    p->nx= (int) ceil(width / SHADOW_CELL) + 1;
+    p->ny= (int) ceil(height / SHADOW_CELL) + 1;
+    p->shadow.clear();
+    if(sigma <= 0)  return;
+
+    p->shadow.resize((size_t) p->nx * p->ny * n_maps);
+    vector <double> field(p->nx * p->ny);
+    double rho= exp(-SHADOW_CELL / corr);
+    for(int m=0; m<n_maps; ++m){
+        unsigned long long state= seed ^ ((unsigned long long) (m+1) << 32);
+        state= splitmix64(&state);  //independent stream of the map
+        shadow_field(field.data(), p->nx, p->ny, rho, &state);
+        for(int i=0; i<p->nx*p->ny; ++i)    p->shadow[(size_t) i*n_maps + m]= pow(10.0, sigma * field[i] / 10);
+    }
+}
+
+/**
+ * Store in @rx the power received at (@ue_x, @ue_y) from the @n BSs at (@x, @y) with transmission power @power, and
+ * in @distance their distances. The BS i uses the shadow map i.
+*/
+void received_power(propagation_t* p, double ue_x, double ue_y, const double* __restrict x, const double* __restrict y,
+                    const double* __restrict power, int n, double* __restrict rx, double* __restrict distance){
+
+    const float* __restrict gain= p->gain.data();
+    double last= p->last;
+    double u[n];    //position in the gain table
+
+    for(int i=0; i<n; ++i){
+        double dx= ue_x - x[i];
+        double dy= ue_y - y[i];
+        distance[i]= sqrt(dx*dx + dy*dy);
+        double v= distance[i] * (1.0 / PROPAGATION_STEP);
+        u[i]= (v < last)?  v : last;
+    }
+
+    for(int i=0; i<n; ++i){
+        int k= (int) u[i];
+        double f= u[i] - k;
+        rx[i]= power[i] * (gain[k] + f * (gain[k+1] - gain[k]));
+    }
+
+    if(p->shadow.empty())   return;
+
+    //bilinear weights of the UE position: the same for all the maps
+    double gx= ue_x / SHADOW_CELL, gy= ue_y / SHADOW_CELL;
+    gx= (gx < 0)?  0 : (gx > p->nx - 1)?  p->nx - 1 : gx;
+    gy= (gy < 0)?  0 : (gy > p->ny - 1)?  p->ny - 1 : gy;
+    int cx= (int) gx, cy= (int) gy;
+    if(cx > p->nx - 2)  cx= p->nx - 2;
+    if(cy > p->ny - 2)  cy= p->ny - 2;
+    double fx= gx - cx, fy= gy - cy;
+    double w00= (1-fx) * (1-fy), w10= fx * (1-fy), w01= (1-fx) * fy, w11= fx * fy;
+
+    const float* __restrict s00= &p->shadow[((size_t) cy*p->nx + cx) * p->n_maps];
+    const float* __restrict s10= s00 + p->n_maps;
+    const float* __restrict s01= s00 + (size_t) p->nx * p->n_maps;
+    const float* __restrict s11= s01 + p->n_maps;
+    for(int i=0; i<n; ++i)  rx[i]*= w00*s00[i] + w10*s10[i] + w01*s01[i] + w11*s11[i];
+}
+
+#endif  /*PROPAGATION_H*/
@@ -0,0 +1,109 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the "replay" subcommand, which re-executes single rounds recorded in a trace (see trace.cpp).
+            replay trace.bin                    list the recorded rounds
+            replay trace.bin ROUND [REPEAT]     re-execute the round ROUND (all its recorded variants) REPEAT times
+        The random generator is restored to its state at the start of the recorded simulation and the round is
+        simulated on the recorded geometry with the default topology, so the same sequence of messages is produced:
+        the round can be inspected under a debugger (e.g. "gdb --args baron replay trace.bin 1234") or a profiler.
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simulation.cpp"
+#include "trace.cpp"
+
+using namespace std;
+
+
+/**
+ * Print the sequence of hops of the round @t
+*/
+void print_hops(trace_round_t* t){
+
+    for(int i=0; i<(int) t->hops.size(); ++i){
+        trace_hop_t* h= &t->hops[i];
+        printf("    %2d -> %2d  %-32s type %d  %.9f\n", h->from, h->to, trace_msg_name(h->msg_type), h->type_transmission, h->handling_time);
+    }
+}
+
+int run_replay(int argc, char* argv[]){
+
+    if(argc < 1){
+        printf("Usage: replay trace.bin [ROUND [REPEAT]]\n");
+        return 1;
+    }
+
+    FILE* f= fopen(argv[0], "rb");
+    if(f == NULL){
+        printf("Replay - can not open %s\n", argv[0]);
+        return 1;
+    }
+
+    char magic[8];
+    unsigned int version;
+    if(!get_bytes(f, magic, 8) || memcmp(magic, TRACE_MAGIC, 8) || !get_bytes(f, &version, sizeof(version)) || version != TRACE_VERSION){
+        printf("Replay - %s is not a valid trace\n", argv[0]);
+        fclose(f);
+        return 1;
+    }
+
+    long long round= (argc > 1)?  atoll(argv[1]) : -1;  //-1 -> list the rounds
+    int repeat= (argc > 2)?  atoi(argv[2]) : 1;
+
+    topology_t topology;
+    default_topology(&topology, 1.0);
+    if(round >= 0)  timer_init(TIMER_STEADY);
+
+    trace_round_t t;
+    int found= 0;
+
+    while(trace_read(f, &t)){
+
+        if(round < 0){
+            printf("round %lld  %s%s  completed %d  hops %d  time %.9f\n", t.round, (t.handover_version)?  "patch" : "std",
+                   (t.is_attacker)?  "_att" : "", t.handover_completed, (int) t.hops.size(), t.time);
+            continue;
+        }
+
+        if(t.round != round)    continue;
+        found++;
+
+        printf("ROUND %lld (seed %u) - %s%s - UE (%d, %d) - rBS (%d, %d) ID %d\n", t.round, t.seed, (t.handover_version)?  "patch" : "std",
+               (t.is_attacker)?  "_att" : "", t.geometry[0], t.geometry[1], t.geometry[2], t.geometry[3], t.geometry[4]);
+        printf("  recorded: completed %d  time %.9f\n", t.handover_completed, t.time);
+        print_hops(&t);
+
+        geometry_t g= {t.geometry[0], t.geometry[1], t.geometry[2], t.geometry[3], t.geometry[4]};
+        round_result_t r;
+
+        trace_file= tmpfile();  //the replayed hops are recorded too, to be compared with the original ones
+        for(int i=0; i<repeat; ++i){
+            rng_state= t.rng_state;
+            simulate_round(&topology, &g, t.handover_version, t.is_attacker, &r);
+        }
+        trace_close();
+
+        printf("  replayed: completed %d  time %.9f\n", r.handover_completed, r.time);
+        print_hops(&trace_tls.current);
+    }
+
+    fclose(f);
+
+    if(round >= 0 && !found){
+        printf("Replay - round %lld is not in the trace\n", round);
+        return 1;
+    }
+    return 0;
+}
+
+#endif  /*REPLAY_H*/
@@ -0,0 +1,56 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file defines the random generator of the simulation.
+        The generator is re-seeded at the start of each round from the campaign seed and the round index, so that
+        each round is fully determined by its counter -> campaigns can be checkpointed, resumed, split and replayed.
+        The state is per-thread, thus rounds can be simulated in parallel.
+*/
+
+#ifndef RNG_H
+#define RNG_H
+
+const int SIM_RAND_MAX= 2147483647;   //maximum value returned by sim_rand() -> same range of rand()
+
+thread_local unsigned long long rng_state= 0x9E3779B97F4A7C15ULL; //state of the random generator of the simulation
+thread_local unsigned int rng_seed= 0;  //campaign seed and index of the current round -> identify the round in the traces
+thread_local long long rng_round= 0;
+
+
+/**
+ * SplitMix64 mixing function -> used to derive the state of a round from its counter
+*/
+unsigned long long splitmix64(unsigned long long x){
+
+    x+= 0x9E3779B97F4A7C15ULL;
+    x= (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x= (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Set the state of the random generator for the round @round of the campaign with seed @seed
+*/
+void seed_round(unsigned int seed, long long round){
+
+    rng_seed= seed;
+    rng_round= round;
+    rng_state= splitmix64(((unsigned long long) seed << 32) ^ splitmix64((unsigned long long) round));
+    if(rng_state == 0)  rng_state= 0x9E3779B97F4A7C15ULL;  //xorshift state can not be 0
+}
+
+/**
+ * Return a random integer in [0, SIM_RAND_MAX] (xorshift64*)
+*/
+int sim_rand(){
+
+    rng_state^= rng_state >> 12;
+    rng_state^= rng_state << 25;
+    rng_state^= rng_state >> 27;
+    return (int) ((rng_state * 0x2545F4914F6CDD1DULL) >> 33);
+}
+
+#endif  /*RNG_H*/
@@ -0,0 +1,173 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the stratified (importance) sampling of the UE placement.
+        The plane is divided in square cells and, once per topology, the probability that a UE placed in each cell
+        produces each case scenario is estimated with predict_bucket(). The geometry for a given case scenario is
+        then drawn from the cells producing it, with the importance weight w.r.t. the uniform placement recorded.
+*/
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+
+#include "simulation.cpp"
+#include "Utility.cpp"
+
+using namespace std;
+
+const int SAMPLER_CELL= 20; //side (m) of the cells
+const int SAMPLER_PROBES= 16;   //number of probe geometries per cell
+const double SAMPLER_DEFENSIVE= 0.05;   //share of the proposal spread uniformly over all the cells -> keeps the estimator unbiased
+const int SAMPLER_MAX_ATTEMPTS= 100000; //maximum number of draws before declaring a case scenario unreachable
+
+typedef struct{
+
+    topology_t* topology;
+    int handover_version;
+    int is_attacker;
+    int nx; //number of cells along the x-axis
+    int ny; //number of cells along the y-axis
+    int n_cells;
+    vector <double> q[3];   //proposal probability of each cell for each case scenario
+    vector <double> cdf[3]; //cumulative of @q, for drawing the cells
+    double p_bucket[3]; //estimated probability of each case scenario under the uniform placement
+
+}sampler_t;
+
+
+/**
+ * Random generator used only for probing the cells -> it does not alter the sequence of the simulation
+*/
+unsigned int probe_random(unsigned int* state){
+
+    *state^= *state << 13;
+    *state^= *state >> 17;
+    *state^= *state << 5;
+    return *state;
+}
+
+/**
+ * Return an integer random number within min and max with the probe generator -> same clamping of random_selection()
+*/
+int probe_selection(int min, int max, unsigned int* state){
+
+    if(min<0)   min=0;
+    return min + (probe_random(state) % (max-min));
+}
+
+/**
+ * Return the side of the cell starting at @start, cut by the plane border @size
+*/
+int cell_size(int start, int size){
+
+    return (start + SAMPLER_CELL > size)?   size - start : SAMPLER_CELL;
+}
+
+/**
+ * Estimate the case scenario probabilities of each cell and build the proposal distributions
+*/
+void init_sampler(sampler_t* s, topology_t* t, int handover_version, int is_attacker){
+
+    s->topology= t;
+    s->handover_version= handover_version;
+    s->is_attacker= is_attacker;
+    s->nx= (t->width + SAMPLER_CELL - 1) / SAMPLER_CELL;
+    s->ny= (t->height + SAMPLER_CELL - 1) / SAMPLER_CELL;
+    s->n_cells= s->nx * s->ny;
+
+    unsigned int state= 2463534242u;
+    vector <double> p[3];
+    for(int k=0; k<3; ++k)  p[k].assign(s->n_cells, 0.0);
+
+    for(int c=0; c<s->n_cells; ++c){
+        int x0= (c % s->nx) * SAMPLER_CELL;
+        int y0= (c / s->nx) * SAMPLER_CELL;
+
+        for(int i=0; i<SAMPLER_PROBES; ++i){
+            geometry_t g;
+            g.ue_x= x0 + probe_selection(0, cell_size(x0, t->width), &state);
+            g.ue_y= y0 + probe_selection(0, cell_size(y0, t->height), &state);
+            g.att_x= 0;
+            g.att_y= 0;
+            g.fake_id= 0;
+
+            if(is_attacker){    //same rules of generate_attacker()
+                int sBS= serving_bs_id(t, g.ue_x, g.ue_y);
+                while((g.fake_id= probe_selection(1, N_LEGIT_BS+1, &state)) == sBS) {}
+                g.att_x= probe_selection(g.ue_x - t->attacker_range, g.ue_x + t->attacker_range, &state);
+                g.att_y= probe_selection(g.ue_y - t->attacker_range, g.ue_y + t->attacker_range, &state);
+            }
+
+            int k= predict_bucket(t, &g, handover_version, is_attacker);
+            if(k != 0)  p[k-1][c]+= 1.0 / SAMPLER_PROBES;
+        }
+    }
+
+    //the cells on the border of the plane can be smaller -> the probabilities are weighted by the cell area
+    vector <double> area(s->n_cells);
+    double plane= (double) t->width * t->height;
+    for(int c=0; c<s->n_cells; ++c) area[c]= (double) cell_size((c % s->nx) * SAMPLER_CELL, t->width) * cell_size((c / s->nx) * SAMPLER_CELL, t->height) / plane;
+
+    for(int k=0; k<3; ++k){
+        double total= 0.0;
+        for(int c=0; c<s->n_cells; ++c) total+= p[k][c] * area[c];
+        s->p_bucket[k]= total;
+
+        s->q[k].assign(s->n_cells, 0.0);
+        s->cdf[k].assign(s->n_cells, 0.0);
+        if(total == 0.0)    continue;   //case scenario never observed -> left to the uniform placement
+
+        double cumulative= 0.0;
+        for(int c=0; c<s->n_cells; ++c){
+            s->q[k][c]= (1.0 - SAMPLER_DEFENSIVE) * p[k][c] * area[c] / total + SAMPLER_DEFENSIVE * area[c];
+            cumulative+= s->q[k][c];
+            s->cdf[k][c]= cumulative;
+        }
+    }
+}
+
+/**
+ * Draw in @g a geometry producing the case scenario @bucket (1, 2 or 3).
+ * Return the importance weight of the geometry w.r.t. the uniform placement of the UE, or -1 if the case scenario is unreachable.
+*/
+double sample_geometry(sampler_t* s, int bucket, geometry_t* g){
+
+    int k= bucket-1;
+
+    for(int attempt=0; attempt<SAMPLER_MAX_ATTEMPTS; ++attempt){
+
+        double weight= 1.0;
+
+        if(s->cdf[k].empty() || s->cdf[k].back() == 0.0){
+            generate_geometry(s->topology, g, s->is_attacker);   //uniform placement
+        }else{
+            double u= ((double) sim_rand() / ((double) SIM_RAND_MAX + 1.0)) * s->cdf[k].back();
+            int c= lower_bound(s->cdf[k].begin(), s->cdf[k].end(), u) - s->cdf[k].begin();
+            if(c >= s->n_cells) c= s->n_cells-1;
+
+            int x0= (c % s->nx) * SAMPLER_CELL;
+            int y0= (c / s->nx) * SAMPLER_CELL;
+            g->ue_x= x0 + random_selection(0, cell_size(x0, s->topology->width));
+            g->ue_y= y0 + random_selection(0, cell_size(y0, s->topology->height));
+            g->att_x= 0;
+            g->att_y= 0;
+            g->fake_id= 0;
+            if(s->is_attacker)  generate_attacker(s->topology, g);
+
+            weight= (double) cell_size(x0, s->topology->width) * cell_size(y0, s->topology->height) / ((double) s->topology->width * s->topology->height * s->q[k][c]);   //uniform density over proposal density
+        }
+
+        if(predict_bucket(s->topology, g, s->handover_version, s->is_attacker) == bucket)   return weight;
+    }
+
+    return -1.0;
+}
+
+#endif  /*SAMPLER_H*/
@@ -0,0 +1,268 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the sharded campaigns.
+        The round index space [1, total_rounds] is split in contiguous shards that are simulated by independent
+        processes. Each shard writes a binary partial result with the round index, the case scenario and the time of
+        every valid round, and the "merge" subcommand puts the rounds of all the shards back in round order and counts
+        them with the same bucket and stopping rules of the single process campaign (fixed_bucket(), fixed_done()),
+        so the samples are exactly the ones a single process simulating the rounds in order would keep.
+        A shard stops once the rules, applied to its own rounds alone, end the campaign: the single process reaches
+        the round with at least as many samples in each case scenario, so it is over by then as well.
+        No communication between the processes is needed, since every round is determined by its index.
+
+        Partial format (native endianness):
+            "BARONPRT" | version (uint32) | config hash (uint64) | shard index (int32) | shard count (int32) |
+            total rounds (int64) | n_rounds (int32) | handover version (int32) | attacker (int32) | n_buckets (int32)
+            for each case scenario: n (uint64) | n records {round (int64), time (float)}
+*/
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#include "Utility.cpp"
+#include "config.cpp"
+#include "simulation.cpp"
+#include "checkpoint.cpp"
+#include "columns.cpp"
+
+using namespace std;
+
+const char PARTIAL_MAGIC[]= "BARONPRT";
+const unsigned int PARTIAL_VERSION= 2;
+
+typedef struct{
+
+    long long round;    //index of the round which produced the sample
+    float time; //overall handover execution time
+
+}shard_sample_t;
+
+typedef struct{
+
+    unsigned long long hash;    //hash of the configuration
+    int shard_index;
+    int shard_count;
+    long long total_rounds;
+    int n_rounds;
+    int handover_version;
+    int is_attacker;
+    vector <shard_sample_t> bucket[3];  //valid rounds by case scenario (classify_round()): [0]= tBS in sAMF; [1]= tBS NOT in sAMF; [2]= reconnection with sBS
+
+}partial_t;
+
+
+/**
+ * Return the first and last round (1-based, inclusive) of the shard @index out of @count
+*/
+void shard_range(long long total_rounds, int index, int count, long long* first, long long* last){
+
+    *first= total_rounds * index / count + 1;
+    *last= total_rounds * (index+1) / count;
+}
+
+/**
+ * Simulate the rounds of the shard and write its partial result
+*/
+int run_shard(config_t* cfg, topology_t* topology){
+
+    int handover_version= cfg->handover_version;
+    int is_attacker= cfg->is_attacker;
+    int n_buckets= 2 + is_attacker;
+
+    partial_t part;
+    part.hash= config_hash(cfg);
+    part.shard_index= cfg->shard_index;
+    part.shard_count= cfg->shard_count;
+    part.total_rounds= cfg->total_rounds;
+    part.n_rounds= cfg->n_rounds;
+    part.handover_version= handover_version;
+    part.is_attacker= is_attacker;
+
+    long long first, last;
+    shard_range(cfg->total_rounds, cfg->shard_index, cfg->shard_count, &first, &last);
+    printf("SHARD %d/%d: rounds %lld - %lld\n", cfg->shard_index, cfg->shard_count, first, last);
+
+    long long count[3]= {0, 0, 0};  //samples of the single process rules applied to the rounds of the shard
+    for(long long j=first; j<=last && !fixed_done(count, cfg->n_rounds, is_attacker); ++j){
+
+        seed_round(cfg->seed, j);   //same round as in a single process campaign
+
+        geometry_t g;
+        generate_geometry(topology, &g, is_attacker);
+
+        round_result_t r;
+        simulate_round(topology, &g, handover_version, is_attacker, &r);
+
+        int k= classify_round(&r, is_attacker);
+        columns_add(j, cfg->seed, handover_version, is_attacker, k, &r);    //the bucket of the round is decided by the merge
+        if(k == 0)  continue;
+
+        int b= fixed_bucket(k, count, cfg->n_rounds);
+        if(b >= 0)  count[b]++;
+
+        shard_sample_t sample= {j, (float) r.time};
+        part.bucket[k-1].push_back(sample);
+    }
+
+    FILE* f= fopen(cfg->partial_file, "wb");
+    if(f == NULL){
+        printf("Shard - can not open %s\n", cfg->partial_file);
+        return 1;
+    }
+
+    fwrite(PARTIAL_MAGIC, 1, 8, f);
+    fwrite(&PARTIAL_VERSION, sizeof(PARTIAL_VERSION), 1, f);
+    fwrite(&part.hash, sizeof(part.hash), 1, f);
+    fwrite(&part.shard_index, sizeof(int), 1, f);
+    fwrite(&part.shard_count, sizeof(int), 1, f);
+    fwrite(&part.total_rounds, sizeof(long long), 1, f);
+    fwrite(&part.n_rounds, sizeof(int), 1, f);
+    fwrite(&part.handover_version, sizeof(int), 1, f);
+    fwrite(&part.is_attacker, sizeof(int), 1, f);
+    fwrite(&n_buckets, sizeof(int), 1, f);
+
+    for(int k=0; k<n_buckets; ++k){
+        unsigned long long n= part.bucket[k].size();
+        fwrite(&n, sizeof(n), 1, f);
+        for(unsigned long long i=0; i<n; ++i){
+            fwrite(&part.bucket[k][i].round, sizeof(long long), 1, f);
+            fwrite(&part.bucket[k][i].time, sizeof(float), 1, f);
+        }
+    }
+
+    fclose(f);
+
+    for(int k=0; k<n_buckets; ++k)  printf("Scenario %d - rounds: %d\n", k+1, (int) part.bucket[k].size());
+    printf("Partial result written in %s\n", cfg->partial_file);
+    return 0;
+}
+
+/**
+ * Read the partial result @file_name into @part. Return 1 on success
+*/
+int read_partial(const char* file_name, partial_t* part){
+
+    FILE* f= fopen(file_name, "rb");
+    if(f == NULL){
+        printf("Merge - can not open %s\n", file_name);
+        return 0;
+    }
+
+    char magic[8];
+    unsigned int version;
+    int n_buckets;
+
+    int ok= get_bytes(f, magic, 8) && !memcmp(magic, PARTIAL_MAGIC, 8) && get_bytes(f, &version, sizeof(version)) && version == PARTIAL_VERSION;
+    ok= ok && get_bytes(f, &part->hash, sizeof(part->hash)) && get_bytes(f, &part->shard_index, sizeof(int)) && get_bytes(f, &part->shard_count, sizeof(int));
+    ok= ok && get_bytes(f, &part->total_rounds, sizeof(long long)) && get_bytes(f, &part->n_rounds, sizeof(int));
+    ok= ok && get_bytes(f, &part->handover_version, sizeof(int)) && get_bytes(f, &part->is_attacker, sizeof(int));
+    ok= ok && get_bytes(f, &n_buckets, sizeof(int)) && n_buckets == 2 + part->is_attacker;
+
+    for(int k=0; ok && k<n_buckets; ++k){
+        unsigned long long n;
+        ok= get_bytes(f, &n, sizeof(n));
+        for(unsigned long long i=0; ok && i<n; ++i){
+            shard_sample_t sample;
+            ok= get_bytes(f, &sample.round, sizeof(long long)) && get_bytes(f, &sample.time, sizeof(float));
+            part->bucket[k].push_back(sample);
+        }
+    }
+
+    fclose(f);
+
+    if(!ok) printf("Merge - %s is not a valid partial result\n", file_name);
+    return ok;
+}
+
+/**
+ * "merge" subcommand: combine the partial results @files into the final results
+*/
+int run_merge(int n_files, char* files[]){
+
+    if(n_files == 0){
+        printf("Usage: merge partial_0.bin partial_1.bin ...\n");
+        return 1;
+    }
+
+    vector <partial_t> parts(n_files);
+    for(int i=0; i<n_files; ++i)    if(!read_partial(files[i], &parts[i]))  return 1;
+
+    //all the shards of the same campaign must be present exactly once
+    partial_t* p0= &parts[0];
+    vector <int> seen(p0->shard_count, 0);
+
+    for(int i=0; i<n_files; ++i){
+        partial_t* p= &parts[i];
+        if(p->hash != p0->hash || p->shard_count != p0->shard_count || p->total_rounds != p0->total_rounds){
+            printf("Merge - %s belongs to a different campaign\n", files[i]);
+            return 1;
+        }
+        if(p->shard_index < 0 || p->shard_index >= p->shard_count || seen[p->shard_index]++){
+            printf("Merge - shard %d is duplicated or invalid\n", p->shard_index);
+            return 1;
+        }
+    }
+
+    for(int s=0; s<p0->shard_count; ++s){
+        if(!seen[s]){
+            printf("Merge - shard %d/%d is missing\n", s, p0->shard_count);
+            return 1;
+        }
+    }
+
+    int n_buckets= 2 + p0->is_attacker;
+    int n_rounds= p0->n_rounds;
+
+    if(p0->handover_version)    printf("PATCHED HANDOVER\n");
+    else    printf("STANDARD HANDOVER\n");
+    if(p0->is_attacker) printf("WITH ATTACKER\n");
+    else printf("NO ATTACKER\n");
+    printf("MERGE OF %d SHARDS\n\n", p0->shard_count);
+
+    char name[64];
+    const char* suffix= (p0->handover_version)?  "patch" : "std";
+    const char* suffix_att= (p0->is_attacker)?  "_att" : "";
+
+    //valid rounds of all the shards in round order
+    vector <pair <shard_sample_t, int>> rounds;
+    for(int i=0; i<n_files; ++i){
+        for(int k=0; k<n_buckets; ++k){
+            for(const shard_sample_t& sample : parts[i].bucket[k])  rounds.push_back(make_pair(sample, k+1));
+        }
+    }
+    sort(rounds.begin(), rounds.end(), [](const pair <shard_sample_t, int>& a, const pair <shard_sample_t, int>& b){return a.first.round < b.first.round;});
+
+    //same counting as the single process campaign
+    vector <float> samples[3];
+    long long count[3]= {0, 0, 0};
+    for(int i=0; i<(int) rounds.size() && !fixed_done(count, n_rounds, p0->is_attacker); ++i){
+        int b= fixed_bucket(rounds[i].second, count, n_rounds);
+        if(b < 0)   continue;
+        samples[b].push_back(rounds[i].first.time);
+        count[b]++;
+    }
+    if(!fixed_done(count, n_rounds, p0->is_attacker))   printf("Merge - the rounds of the shards do not complete the campaign: increase --total-rounds\n");
+
+    for(int k=0; k<n_buckets; ++k){
+        sprintf(name, "results%d_%s%s.xls", k+1, suffix, suffix_att);
+        FILE* write= fopen(name, "w");
+        double m= write_results(write, &samples[k], n_rounds);
+        fclose(write);
+
+        printf("SCENARIO %d - MEDIAN: %.9f\n", k+1, m);
+    }
+
+    puts("CORRECTLY TERMINATED");
+    return 0;
+}
+
+#endif  /*SHARD_H*/
@@ -0,0 +1,677 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements a single round of the handover simulation.
+        The geometry of the round (UE position, attacker position and fake ID) is drawn separately from the
+        handover procedure, so that the same geometry can be simulated with different handover variants.
+*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+
+#include "user.cpp"
+#include "base_station.cpp"
+#include "AMF.cpp"
+#include "Utility.cpp"
+#include "message.cpp"
+#include "trace.cpp"
+#include "timer.cpp"
+#include "profile.cpp"
+#include "measure.cpp"
+#include "perf.cpp"
+#include "costmodel.cpp"
+#include "chrome.cpp"
+#include "alloc.cpp"
+#include "propagation.cpp"
+
+using namespace std;
+using namespace chrono;
+
+const int N_LEGIT_BS= 12;   //number of legitimate base stations
+
+//Layout of the legitimate BSs: ID, x position, y position, ID of the controlling AMF
+const int BS_LAYOUT[N_LEGIT_BS][4]= {
+    {1, 200, 1000, 1},
+    {2, 450, 800, 1},
+    {3, 800, 400, 1},
+    {4, 1000, 50, 1},
+    {5, 100, 650, 1},
+    {6, 300, 200, 1},
+
+    {7, 950, 900, 2},
+    {8, 1250, 500, 2},
+    {9, 1400, 250, 2},
+    {10, 1200, 1100, 2},
+    {11, 1850, 1000, 2},
+    {12, 2000, 750, 2}
+};
+
+//Layout of the AMFs: ID, x position, y position
+const int AMF_LAYOUT[2][3]= {
+    {1, 0, 0},
+    {2, 2200, 1100}
+};
+
+
+typedef struct{
+
+    int bs[N_LEGIT_BS][4];  //legitimate BSs: ID, x position, y position, ID of the controlling AMF
+    int amf[2][3];  //AMFs: ID, x position, y position
+    int width;  //x-axis size of the plane where the UE is placed
+    int height; //y-axis size of the plane where the UE is placed
+    int bs_power;   //transmission power of the legitimate BSs
+    int attacker_power; //transmission power of the attacker (rBS)
+    int attacker_range; //maximum distance along each axis of the attacker from the UE
+    double wired[N_LEGIT_BS+2][N_LEGIT_BS+2];   //propagation delay (s) of the wired links -> legitimate BSs (position in the layout), AMF-1, AMF-2
+    propagation_t* propagation; //path loss model of the beacons -> NULL = free space PT/d^2 of the original simulation
+
+}topology_t;
+
+
+typedef struct{
+
+    int ue_x;   //x-axis coordinate of the UE
+    int ue_y;   //y-axis coordinate of the UE
+    int att_x;  //x-axis coordinate of the attacker -> valid only if the geometry has been drawn with the attacker
+    int att_y;  //y-axis coordinate of the attacker
+    int fake_id;    //BS_id emulated by the attacker
+
+}geometry_t;
+
+typedef struct{
+
+    /*
+        Result of the handover:
+        - 0= no handover needed (round not valid)
+        - 1= handover successful
+        - 2= handover failed + reconnection recovery successful
+        - -1= handover failed + reconnection recovery rejected
+        - -2= handover failed + reconnection recovery aborted (BS failed in authentication)
+    */
+    int handover_completed;
+    double time;    //overall handover execution time
+    int sBS;    //ID of the BS to which UE was connected before handover
+    int tBS;    //ID of the target BS -> in case of attack, this is the BS for reconnection
+    int same_AMF;   //1 if sBS and tBS are controlled by the same AMF
+    double step_time[TRACE_N_MSG_TYPES];    //handling time of each message type -> only with record_steps
+    double propagation; //overall propagation delay -> only with record_steps
+
+}round_result_t;
+
+
+/**
+ * Precompute the propagation delays of the wired links of @t (same computation of compute_delay) -> to be called
+ * again whenever the positions of the BSs or of the AMFs change
+*/
+void wired_delays(topology_t* t){
+
+    int pos[N_LEGIT_BS+2][2];
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        pos[i][0]= t->bs[i][1];
+        pos[i][1]= t->bs[i][2];
+    }
+    for(int i=0; i<2; ++i){
+        pos[N_LEGIT_BS+i][0]= t->amf[i][1];
+        pos[N_LEGIT_BS+i][1]= t->amf[i][2];
+    }
+
+    for(int i=0; i<N_LEGIT_BS+2; ++i){
+        for(int j=0; j<N_LEGIT_BS+2; ++j)   t->wired[i][j]= sqrt(pow(pos[i][0] - pos[j][0], 2) + pow(pos[i][1] - pos[j][1], 2)) / LIGHT_SPEED_WIRE;
+    }
+}
+
+/**
+ * Set the topology of the original simulation: @scale multiplies the BS positions and the plane size
+*/
+void default_topology(topology_t* t, double scale){
+
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        t->bs[i][0]= BS_LAYOUT[i][0];
+        t->bs[i][1]= (int) (BS_LAYOUT[i][1] * scale);
+        t->bs[i][2]= (int) (BS_LAYOUT[i][2] * scale);
+        t->bs[i][3]= BS_LAYOUT[i][3];
+    }
+
+    for(int i=0; i<2; ++i){
+        t->amf[i][0]= AMF_LAYOUT[i][0];
+        t->amf[i][1]= (int) (AMF_LAYOUT[i][1] * scale);
+        t->amf[i][2]= (int) (AMF_LAYOUT[i][2] * scale);
+    }
+
+    t->width= (int) (2200 * scale);
+    t->height= (int) (1300 * scale);
+    t->bs_power= 100;
+    t->attacker_power= 100;
+    t->attacker_range= 150;
+    t->propagation= NULL;
+
+    wired_delays(t);
+}
+
+/**
+ * Attach to @t the path loss model @model (see init_propagation()), with the gain table covering the largest UE-BS and
+ * UE-rBS distance of the topology -> to be called after the BS positions, the plane and the attacker range are set
+*/
+void set_propagation(topology_t* t, int model, double exponent, double carrier, double sigma, double corr, unsigned long long seed){
+
+    double max_distance= t->attacker_range * sqrt(2.0);
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        for(int c=0; c<4; ++c){ //corners of the plane
+            double d= sqrt(pow((c & 1)*t->width - t->bs[i][1], 2) + pow((c >> 1)*t->height - t->bs[i][2], 2));
+            if(d > max_distance)    max_distance= d;
+        }
+    }
+
+    t->propagation= new propagation_t;
+    init_propagation(t->propagation, model, exponent, carrier, sigma, corr, t->width, t->height, max_distance, N_LEGIT_BS+1, seed);
+}
+
+/**
+ * Fill @channel with the power received by the UE of @g with the path loss model of @t, and @distance with the UE-BS
+ * distances -> same order as the BSs of the round (rBS last, with the fake ID)
+*/
+void model_beacons(topology_t* t, geometry_t* g, int n_bs, double channel[][2], double distance[]){
+
+    double x[n_bs], y[n_bs], power[n_bs], rx[n_bs];  //SoA of the BSs
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        x[i]= t->bs[i][1];
+        y[i]= t->bs[i][2];
+        power[i]= t->bs_power;
+    }
+    if(n_bs > N_LEGIT_BS){
+        x[n_bs-1]= g->att_x;
+        y[n_bs-1]= g->att_y;
+        power[n_bs-1]= t->attacker_power;
+    }
+
+    received_power(t->propagation, g->ue_x, g->ue_y, x, y, power, n_bs, rx, distance);
+
+    for(int i=0; i<n_bs; ++i){
+        channel[i][0]= rx[i];
+        channel[i][1]= (i < N_LEGIT_BS)?  t->bs[i][0] : g->fake_id;
+    }
+}
+
+/**
+ * Return the ID of the BS the UE at (x, y) is connected to at the start of the round -> the second closest legitimate BS.
+ * Same selection as ue_set_connected(), but computed on the BS layout without building the entities.
+*/
+int serving_bs_id(topology_t* t, int x, int y){
+
+    float closest= 0.0, closest_2= 0.0;
+    int index= -1, index_2= -1;
+
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        float distance= sqrt(pow(x - t->bs[i][1], 2) + pow(y - t->bs[i][2], 2));
+
+        if(index == -1 || distance < closest){
+            closest_2= closest;
+            closest= distance;
+
+            index_2= index;
+            index= i;
+        }else if(index_2 == -1 || distance < closest_2){
+            closest_2= distance;
+            index_2= i;
+        }
+    }
+
+    return t->bs[index_2][0];
+}
+
+/**
+ * Draw the attacker fields of the geometry @g, whose UE position is already set
+*/
+void generate_attacker(topology_t* t, geometry_t* g){
+
+    //This fake BS_id must not be the same as the one the UE is connected to for simulation
+    int sBS= serving_bs_id(t, g->ue_x, g->ue_y);
+    while((g->fake_id= random_selection(1, N_LEGIT_BS+1)) == sBS) {}
+
+    //within ray of attacker_range (150m by default) w.r.t. UE location
+    g->att_x= random_selection(g->ue_x - t->attacker_range, g->ue_x + t->attacker_range);
+    g->att_y= random_selection(g->ue_y - t->attacker_range, g->ue_y + t->attacker_range);
+}
+
+/**
+ * Draw the geometry of a round. The attacker fields are drawn only if @is_attacker.
+ * The random draws are done in the same order as the original simulation loop.
+*/
+void generate_geometry(topology_t* t, geometry_t* g, int is_attacker){
+
+    g->ue_x= random_selection(0, t->width);
+    g->ue_y= random_selection(0, t->height);
+
+    g->att_x= 0;
+    g->att_y= 0;
+    g->fake_id= 0;
+
+    if(is_attacker) generate_attacker(t, g);
+}
+
+/**
+ * Return 1 if the best received signal in @channel is the one of the rBS (last position), keeping the first maximum as select_best_bs()
+*/
+int probe_is_rbs(double channel[][2], int n_bs){
+
+    int best= 0;
+    for(int i=1; i<n_bs; ++i)   if(channel[i][0] > channel[best][0])   best= i;
+
+    return best == n_bs-1;
+}
+
+/**
+ * Return the case scenario the round with geometry @g falls in, without simulating the handover:
+ *  - 0= no handover needed (round not valid)
+ *  - 1= tBS in sAMF
+ *  - 2= tBS NOT in sAMF
+ *  - 3= under attack, reconnection with sBS
+ * In case of attack, tBS is the BS for the reconnection. The prediction assumes that the rBS always fails the
+ * BARON authentication -> the actual scenario of a simulated round is still given by classify_round().
+*/
+int predict_bucket(topology_t* t, geometry_t* g, int handover_version, int is_attacker){
+
+    int n_bs= N_LEGIT_BS + is_attacker*1;
+    double channel[n_bs][2];
+
+    //same received power computation of transmit_beacons(), with the transmission power of the BSs
+    if(t->propagation != NULL){
+        double distance[n_bs];
+        model_beacons(t, g, n_bs, channel, distance);
+    }else{
+        for(int i=0; i<N_LEGIT_BS; ++i){
+            channel[i][0]= t->bs_power / pow(sqrt(pow(g->ue_x - t->bs[i][1], 2) + pow(g->ue_y - t->bs[i][2], 2)), 2);
+            channel[i][1]= t->bs[i][0];
+        }
+        if(is_attacker){
+            channel[n_bs-1][0]= t->attacker_power / pow(sqrt(pow(g->ue_x - g->att_x, 2) + pow(g->ue_y - g->att_y, 2)), 2);
+            channel[n_bs-1][1]= g->fake_id;
+        }
+    }
+
+    user probe(12, g->ue_x, g->ue_y, handover_version, is_attacker);   //used only for the BS selection
+    int sBS= serving_bs_id(t, g->ue_x, g->ue_y);
+    int tBS= probe.select_best_bs(channel, n_bs);
+
+    if(tBS == sBS)  return 0;
+
+    //under BARON, the handover towards the rBS fails -> reconnection recovery with the best BS excluding the fake ID
+    if(is_attacker && handover_version && probe_is_rbs(channel, n_bs)){
+        tBS= probe.select_best_bs(channel, n_bs, tBS);
+        if(tBS == sBS)  return 3;
+    }
+
+    return (t->bs[sBS-1][3] == t->bs[tBS-1][3])?   1 : 2;
+}
+
+/**
+ * Return the case scenario of a simulated round (same values as predict_bucket())
+*/
+int classify_round(round_result_t* r, int is_attacker){
+
+    if(r->handover_completed == 0)  return 0;
+    if(is_attacker && r->sBS == r->tBS) return 3;   //reconnection with sBS
+    return (r->same_AMF)?   1 : 2;
+}
+
+/**
+ * Return the bucket (0-based) in which the fixed-size campaign counts a round of case scenario @k (classify_round()),
+ * given the samples @count already in each bucket, or -1 if the round is not counted -> same rule as the original
+ * simulation loop: a round whose case scenario is full is counted in the case scenario 1 while it has room
+*/
+int fixed_bucket(int k, const long long count[], int n_rounds){
+
+    if(k == 3 && count[2] < n_rounds)   return 2;   //reconnection with sBS
+    if(k == 2 && count[1] < n_rounds)   return 1;   //tBS NOT in sAMF
+    if(k != 0 && count[0] < n_rounds)   return 0;   //tBS in sAMF
+    return -1;
+}
+
+/**
+ * Return 1 if the fixed-size campaign with @count samples per bucket is over -> same stopping condition as the original
+ * simulation loop: case scenarios 1 and 2 full or, under attack, case scenario 3 full
+*/
+int fixed_done(const long long count[], int n_rounds, int is_attacker){
+
+    if(count[0] >= n_rounds && count[1] >= n_rounds)    return 1;
+    return is_attacker && count[2] >= n_rounds;
+}
+
+/**
+ * Create the AMFs and the legitimate BSs of the topology. @bs must have @n_bs elements: the last one is left for the attacker.
+*/
+void create_topology(topology_t* t, vector <AMF*>* amf, vector <base_station*>* bs, int n_bs, int handover_version){
+
+    for(int i=0; i<2; ++i)  (*amf)[i]= new AMF(t->amf[i][0], t->amf[i][1], t->amf[i][2], n_bs, handover_version);
+
+    for(int i=0; i<N_LEGIT_BS; ++i){
+        int amf_id= t->bs[i][3];
+        (*bs)[i]= new base_station(t->bs[i][0], t->bs[i][1], t->bs[i][2], handover_version, 0, amf_id, n_bs + amf_id);
+        (*bs)[i]->set_power(t->bs_power);
+    }
+}
+
+/**
+ * Return the index in the message channel of the entity handling the next message -> same order as the round loop
+*/
+int next_handler(message_channel* msg, int n_bs){
+
+    if(msg->is_ready(0))    return 0;
+    if(msg->is_ready(n_bs+1))   return n_bs+1;
+    if(msg->is_ready(n_bs+2))   return n_bs+2;
+    return msg->first();    //BSs
+}
+
+/**
+ * Function called before each step of the round (with @h= -1 before the Measurement Report transmission, otherwise
+ * with the index in @msg of the entity handling the next message) -> used by the micro-benchmarks
+*/
+typedef void (*round_hook_t)(user* ue, vector <base_station*>* bs, vector <AMF*>* amf, message_channel* msg, int h, int n_bs, double channel[][2]);
+round_hook_t round_hook= NULL;
+int record_steps= 0;    //1 -> the round result holds the handling time of each message type
+
+/**
+ * Time the handling of the message in the slot @h of the channel @msg on clones of the message and of the handling
+ * entity: the state of the round (entities, channel and random generator) is not affected
+*/
+template <bool Patched>
+double time_clone(user* ue, vector <base_station*>* bs, vector <AMF*>* amf, message_channel* msg, int h, int n_bs, double channel[][2]){
+
+    int key= alloc_pause(); //the clones are not part of the round
+    message_channel scratch(n_bs+3);
+    scratch.post(h, *msg->get(h));
+
+    int handover_completed= 0;
+    int type_transmission= 0;
+    unsigned long long saved= rng_state;
+    unsigned long long start, stop;
+
+    if(h == 0){
+        user clone= *ue;
+        start= timer_start();
+        clone.handle_message<Patched>(&scratch, scratch.get(0), channel, &handover_completed, &type_transmission);
+        stop= timer_stop();
+
+    }else if(h > n_bs){
+        AMF clone= *(*amf)[h-n_bs-1];
+        start= timer_start();
+        clone.handle_message<Patched>(&scratch, scratch.get(h), &type_transmission);
+        stop= timer_stop();
+
+    }else{
+        base_station clone= *(*bs)[h-1];
+        start= timer_start();
+        clone.handle_message<Patched>(&scratch, scratch.get(h), &type_transmission);
+        stop= timer_stop();
+    }
+
+    rng_state= saved;
+    alloc_resume(key);
+
+    return timer_seconds(start, stop);
+}
+
+/**
+ * Simulate the handover procedure of one round of the variant @Patched/@Attacker on the geometry @g and store the outcome in @r.
+ * The variant is fixed at compile time: the standard version does not contain the BARON code and the channels have constant size
+*/
+template <bool Patched, bool Attacker>
+void simulate_variant(topology_t* t, geometry_t* g, round_result_t* r){
+
+    const int handover_version= Patched;
+    const int is_attacker= Attacker;
+    const int n_bs= N_LEGIT_BS + Attacker;  //number of base stations (BS) -> this comprises also the attacker
+    static thread_local message_channel channel_msg(n_bs+3);    //reused by the rounds of the thread -> allocated before the round tracking
+    int tracing= (trace_file != NULL);
+    int profiling= profile_enabled;
+    int repeat= measure_repeat;
+    int modeled= cost_enabled;  //1 -> no clock: the handling times come from the cost model
+    double times[repeat];   //executions of the same handle_message
+
+    int geometry[5]= {g->ue_x, g->ue_y, g->att_x, g->att_y, g->fake_id};
+    if(tracing) trace_begin(handover_version, is_attacker, geometry);  //before any random number of the round
+    int charting= chrome_enabled && chrome_begin(rng_round, handover_version, is_attacker, n_bs);   //sampled round for the Chrome trace
+    alloc_round_begin(handover_version, is_attacker);
+
+    vector <float> time; //maintains the round time simulation
+    int handover_completed= 0;
+
+    r->handover_completed= 0;
+    r->time= 0.0;
+    r->propagation= 0.0;
+    for(int m=0; m<TRACE_N_MSG_TYPES; ++m)  r->step_time[m]= 0.0;
+
+    //---------------------------------------------- INITIALIZATION -----------------------------//
+
+    vector <AMF*> amf(2);
+    vector <base_station*> bs(n_bs); //collection of base stations
+    create_topology(t, &amf, &bs, n_bs, handover_version);
+
+    user* ue= new user(12, g->ue_x, g->ue_y, handover_version, is_attacker);
+    ue_set_connected(ue, bs, (is_attacker)? n_bs-1 : n_bs); //create the connection of the UE with sBS -> sBS is the 2nd closest BS, so to always be in case of handover needed.
+
+    if constexpr(Attacker){
+        bs[n_bs-1]= new base_station(g->fake_id, g->att_x, g->att_y, handover_version, 1, 0, -1);
+        bs[n_bs-1]->set_power(t->attacker_power);
+    }
+
+    /*
+        This represents the channel sensed by the user when it has to measure beacons from other BS.
+        Column 0-> signal power received
+        Column 1-> ID of corresponding BS
+    */
+    double channel[n_bs][2];
+
+    /*
+        This is the channel for simulating the transmission of messages.
+        The correspondence is as follows:
+            - position 0 -> ue
+            - position 1 -> bs[0]
+            - ....
+            - position X -> ATTACKER
+            - last position -1 -> AMF-1
+            - last postion -> AMF-2
+    */
+    message_channel* msg= &channel_msg;
+    msg->reset();
+
+
+    //--------------------------------------- MEASUREMENT REPORT TRANSMISSION --------------------------------//
+
+    double air[n_bs];   //propagation delay of the air link between the UE and each BS
+    if(t->propagation == NULL)  transmit_beacons(channel, air, n_bs, ue, bs);    //populate @channel with the received power signals and corresponding BS-IDs
+    else    model_beacons(t, g, n_bs, channel, air);
+    for(int i=0; i<n_bs; ++i)   air[i]/= LIGHT_SPEED_FREE;  //distance -> delay
+    int best_bs= ue->select_best_bs(channel, n_bs); //select the best BS and target the index
+
+    if(ue->get_connected() != best_bs){
+
+        ue->set_target(best_bs);    //set the ID of the target BS
+        if(round_hook != NULL)  round_hook(ue, &bs, &amf, msg, -1, n_bs, channel);
+        ue->transmit_message<Patched>(msg, MSG_MEASUREMENT_REPORT);    //transmit the measurement report message
+
+        time.push_back(air[ue->get_connected()-1]);   //-1 because of the disallignement between BS_id and position in bs
+        if(profiling)   profile_add(handover_version, is_attacker, PROFILE_LINK, 1, time.back());
+        if(charting)    chrome_hop(0, ue->get_connected(), MSG_MEASUREMENT_REPORT, 0.0, time.back());   //transmission not timed
+        if(record_steps)    r->propagation+= time.back();
+
+
+        //------------------------------------ HANDOVER PROCEDURE ---------------------------------------------//
+
+        /*
+            Defines the type of transmission = source - receiver. Used to compute the transmission delay:
+            - 1 = ue -> BS
+            - 2 = BS -> AMF
+            - 3 = AMF <-> AMF
+            - 4 = BS <-> BS
+            - 5 = AMF -> BS
+            - 6 = BS -> UE
+        */
+        int type_transmission= 0;   //it is set within the message handling function
+
+        int from= 0;    //index in the msg data stucture of the transmitter
+        int to= 0;  //index in the msg data stucture of the receiver
+
+        while(handover_completed == 0){ //loop until the handover is completed
+
+            int h= next_handler(msg, n_bs);
+            int msg_type= msg->get(h)->get_type();  //before the handling, which may overwrite the slot
+            int kind= (h == 0)?  PROFILE_UE : (h > n_bs)?  PROFILE_AMF : (is_attacker && h == n_bs)?  PROFILE_RBS : PROFILE_BS;
+
+            if(round_hook != NULL)  round_hook(ue, &bs, &amf, msg, h, n_bs, channel);
+            for(int k=0; !modeled && k<repeat-1; ++k)   times[k]= time_clone<Patched>(ue, &bs, &amf, msg, h, n_bs, channel);
+
+            int counting= perf_enabled && perf_begin(); //hardware counters read outside the timed region
+
+            alloc_step(profile_key(handover_version, is_attacker, kind, msg_type));
+            unsigned long long start= (modeled)?  0 : timer_start();    //start the timer for comoputing the time for message handling
+
+            if(h == 0)  ue->handle_message<Patched>(msg, msg->get(0), channel, &handover_completed, &type_transmission);  //UE
+            else if(h > n_bs)   amf[h-n_bs-1]->handle_message<Patched>(msg, msg->get(h), &type_transmission);   //AMF-1, AMF-2
+            else    bs[h-1]->handle_message<Patched>(msg, msg->get(h), &type_transmission);    //h-1 because of the different position in the two arrays
+            from= h;
+
+            unsigned long long stop= (modeled)?  0 : timer_stop(); //stop the timer
+            alloc_step(-1);
+            if(counting)    perf_end(profile_key(handover_version, is_attacker, kind, msg_type));
+
+            if(modeled) time.push_back(step_cost(handover_version, is_attacker, kind, msg_type));   //processing time from the cost profile
+            else{
+                times[repeat-1]= timer_seconds(start, stop);
+                time.push_back(reduce_times(times, repeat));    //store the handling time (timer overhead excluded)
+            }
+
+            int sent= !msg->empty();
+            if(sent)    to= msg->last();    //save the receiver
+
+            if(tracing) trace_hop(from, to, msg_type, type_transmission, time.back());
+            if(profiling){
+                profile_add(handover_version, is_attacker, kind, msg_type, time.back());
+            }
+
+            int n_times= time.size();
+
+            //Compute the transmission time
+            switch(type_transmission){
+                case 1: //UE -> BS
+                    time.push_back(air[to-1]);
+                break;
+
+                case 2: //BS -> AMF
+                    time.push_back(t->wired[from-1][N_LEGIT_BS + to-n_bs-1]);
+                break;
+
+                case 3: //AMF <-> AMF
+                    time.push_back(t->wired[N_LEGIT_BS][N_LEGIT_BS+1]);
+                break;
+
+                case 4: //BS <-> BS
+                    time.push_back(t->wired[from-1][to-1]);
+                break;
+
+                case 5: //AMF -> BS -> as computed so far: distance between the tBS and bs[from-n_bs-1] (BS 1 or 2), not the AMF
+                    time.push_back(t->wired[to-1][from-n_bs-1]);
+                break;
+
+                case 6: //BS -> ue
+                    time.push_back(air[from-1]);
+                break;
+
+                default: ;
+                break;
+            }
+
+            if(profiling && (int) time.size() > n_times)  profile_add(handover_version, is_attacker, PROFILE_LINK, type_transmission, time.back());
+            if(charting)    chrome_hop(from, (sent)?  to : from, msg_type, time[n_times-1], ((int) time.size() > n_times)?  time.back() : 0.0);
+            if(record_steps){
+                if(msg_type < TRACE_N_MSG_TYPES)    r->step_time[msg_type]+= time[n_times-1];
+                if((int) time.size() > n_times)   r->propagation+= time.back();
+            }
+
+        } //#while(!handover_completed)
+
+        //compute the overall run-time execution
+        double sum= 0.0;
+        for(int i=0; i<(int) time.size(); ++i)    sum+= time[i];
+
+        r->handover_completed= handover_completed;
+        r->time= sum;
+        r->sBS= ue->get_connected();
+        r->tBS= ue->get_target();
+        r->same_AMF= (bs[r->sBS-1]->get_AMF() == bs[r->tBS-1]->get_AMF());
+
+        if(tracing) trace_end(handover_completed, sum);
+        if(charting)    chrome_end(r->sBS, r->tBS, sum);
+
+    } //#if(measurement report)
+
+    //delete the entities for memory saving
+    delete ue;
+    for(int i=0; i<n_bs; ++i)   delete bs[i];
+    for(int i=0; i<(int) amf.size(); ++i) delete amf[i];
+
+    alloc_round_end();
+}
+
+/**
+ * Simulate the handover procedure of one round on the geometry @g and store the outcome in @r -> dispatch to the variant
+*/
+void simulate_round(topology_t* t, geometry_t* g, int handover_version, int is_attacker, round_result_t* r){
+
+    if(handover_version){
+        if(is_attacker) simulate_variant<true, true>(t, g, r);
+        else    simulate_variant<true, false>(t, g, r);
+    }else{
+        if(is_attacker) simulate_variant<false, true>(t, g, r);
+        else    simulate_variant<false, false>(t, g, r);
+    }
+}
+
+/**
+ * Simulate @n_rounds rounds that are not part of the campaign (negative round indices), without trace, profile, Chrome trace,
+ * hardware counters and allocation tracking, so that the campaign starts with the pages mapped and the caches warm
+*/
+void warm_up(topology_t* t, unsigned int seed, int n_rounds, int handover_version, int is_attacker, int paired){
+
+    FILE* trace= trace_file;
+    int profiling= profile_enabled;
+    int charting= chrome_enabled;
+    int counting= perf_enabled;
+    int allocating= alloc_enabled;
+    int key= alloc_pause(); //no allocation charged to a step or to a round
+    trace_file= NULL;
+    profile_enabled= 0;
+    chrome_enabled= 0;
+    perf_enabled= 0;
+    alloc_enabled= 0;
+
+    for(int i=1; i<=n_rounds; ++i){
+        seed_round(seed, -i);
+
+        geometry_t g;
+        generate_geometry(t, &g, 1);
+
+        round_result_t r;
+        if(paired){
+            simulate_round(t, &g, 0, 0, &r);
+            simulate_round(t, &g, 1, 0, &r);
+            simulate_round(t, &g, 1, 1, &r);
+        }else   simulate_round(t, &g, handover_version, is_attacker, &r);
+    }
+
+    trace_file= trace;
+    profile_enabled= profiling;
+    chrome_enabled= charting;
+    perf_enabled= counting;
+    alloc_enabled= allocating;
+    alloc_resume(key);
+}
+
+#endif  /*SIMULATION_H*/
@@ -0,0 +1,244 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the streaming statistics of a case scenario, used instead of storing every sample when
+        the campaign runs with --sketch EPS:
+            - Welford mean and variance (plus minimum and maximum)
+            - KLL quantile sketch (Karnin, Lang, Liberty): a hierarchy of compactors, where the items of level h weigh
+              2^h. A full compactor is sorted and one item out of each pair (odd or even positions, by coin flip) is
+              promoted to the next level. The capacity of level h is k * (2/3)^(H-1-h), so the memory is O(k) for any
+              number of samples, and the normalized rank error is about 3.3/k at 99% confidence -> k = 3.3/EPS.
+        Both structures are mergeable (per thread, per shard). The coin flips use a private generator, so the
+        simulation random sequence is not touched and the sketch is reproducible.
+*/
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include "Utility.cpp"
+
+using namespace std;
+
+typedef struct{
+
+    long long n;
+    double mean;
+    double m2;  //sum of the squared deviations from the mean
+    double min;
+    double max;
+
+}welford_t;
+
+class kll_sketch{
+    public:
+        int k;  //accuracy parameter: capacity of the top level
+        long long n= 0; //samples added
+        vector <vector <float>> compactors; //level h -> items of weight 2^h
+        unsigned long long coin= 0x9E3779B97F4A7C15ULL;    //private generator of the coin flips
+
+        kll_sketch(int k= 200);
+        void add(float value);
+        void merge(const kll_sketch& other);
+        double quantile(double p);  //value of normalized rank @p
+        void weighted(vector <stat_t>* b);  //retained values with their weights, in increasing order of value
+        int retained(); //items held by the sketch
+
+    private:
+        int capacity(int h);
+        void compress();
+};
+
+typedef struct{
+
+    welford_t moments;
+    kll_sketch quantiles;
+
+}stream_stat_t;
+
+
+void welford_init(welford_t* w){
+
+    w->n= 0;
+    w->mean= 0.0;
+    w->m2= 0.0;
+    w->min= INFINITY;
+    w->max= -INFINITY;
+}
+
+void welford_add(welford_t* w, double value){
+
+    w->n++;
+    double delta= value - w->mean;
+    w->mean+= delta / w->n;
+    w->m2+= delta * (value - w->mean);
+    if(value < w->min)  w->min= value;
+    if(value > w->max)  w->max= value;
+}
+
+/**
+ * Merge @b into @a (Chan et al. parallel update)
+*/
+void welford_merge(welford_t* a, const welford_t* b){
+
+    if(b->n == 0)   return;
+
+    long long n= a->n + b->n;
+    double delta= b->mean - a->mean;
+    a->m2+= b->m2 + delta * delta * a->n * b->n / n;
+    a->mean+= delta * b->n / n;
+    a->n= n;
+    if(b->min < a->min) a->min= b->min;
+    if(b->max > a->max) a->max= b->max;
+}
+
+double welford_variance(welford_t* w){
+
+    return (w->n > 1)?  w->m2 / (w->n - 1) : 0.0;
+}
+
+
+kll_sketch::kll_sketch(int k){
+
+    this->k= (k < 8)?  8 : k;
+    compactors.resize(1);
+}
+
+int kll_sketch::capacity(int h){
+
+    int c= (int) ceil(k * pow(2.0/3.0, compactors.size() - 1 - h));
+    return (c < 2)?  2 : c;
+}
+
+/**
+ * Compact the full levels: sort, promote one item out of each pair, keep the odd one out
+*/
+void kll_sketch::compress(){
+
+    for(int h=0; h<(int) compactors.size(); ++h){
+        if((int) compactors[h].size() < capacity(h))  continue;
+
+        if(h+1 == (int) compactors.size())    compactors.resize(h+2);
+
+        vector <float>& level= compactors[h];
+        sort(level.begin(), level.end());
+
+        coin^= coin << 13;  //xorshift64
+        coin^= coin >> 7;
+        coin^= coin << 17;
+        int offset= coin & 1;
+
+        int even= level.size() - level.size() % 2;
+        for(int i=offset; i<even; i+=2) compactors[h+1].push_back(level[i]);
+
+        float odd= level.back();
+        int has_odd= level.size() % 2;
+        level.clear();
+        if(has_odd) level.push_back(odd);
+    }
+}
+
+void kll_sketch::add(float value){
+
+    compactors[0].push_back(value);
+    n++;
+    if((int) compactors[0].size() >= capacity(0)) compress();
+}
+
+void kll_sketch::merge(const kll_sketch& other){
+
+    if(other.compactors.size() > compactors.size()) compactors.resize(other.compactors.size());
+    for(int h=0; h<(int) other.compactors.size(); ++h){
+        compactors[h].insert(compactors[h].end(), other.compactors[h].begin(), other.compactors[h].end());
+    }
+    n+= other.n;
+    compress();
+}
+
+void kll_sketch::weighted(vector <stat_t>* b){
+
+    vector <pair <float, int>> items;
+    for(int h=0; h<(int) compactors.size(); ++h){
+        for(int i=0; i<(int) compactors[h].size(); ++i)   items.push_back(make_pair(compactors[h][i], 1 << h));
+    }
+    sort(items.begin(), items.end());
+
+    b->clear();
+    for(int i=0; i<(int) items.size(); ++i){
+        if(!b->empty() && b->back().value == items[i].first)    b->back().occurences+= items[i].second;
+        else{
+            stat_t temp;
+            temp.value= items[i].first;
+            temp.occurences= items[i].second;
+            b->push_back(temp);
+        }
+    }
+}
+
+double kll_sketch::quantile(double p){
+
+    vector <stat_t> b;
+    weighted(&b);
+    if(b.empty())   return 0.0;
+
+    long long total= 0;
+    for(int i=0; i<(int) b.size(); ++i)   total+= b[i].occurences;   //= n: the compactions preserve the total weight
+
+    double rank= p * total;
+    long long count= 0;
+    for(int i=0; i<(int) b.size(); ++i){
+        count+= b[i].occurences;
+        if(count > rank)    return b[i].value;
+    }
+    return b.back().value;
+}
+
+int kll_sketch::retained(){
+
+    int r= 0;
+    for(int h=0; h<(int) compactors.size(); ++h)  r+= compactors[h].size();
+    return r;
+}
+
+
+/**
+ * Initialize @s for the normalized rank error @error
+*/
+void stream_init(stream_stat_t* s, double error){
+
+    welford_init(&s->moments);
+    s->quantiles= kll_sketch((int) ceil(3.3 / error));
+}
+
+void stream_add(stream_stat_t* s, float value){
+
+    welford_add(&s->moments, value);
+    s->quantiles.add(value);
+}
+
+void stream_merge(stream_stat_t* a, stream_stat_t* b){
+
+    welford_merge(&a->moments, &b->moments);
+    a->quantiles.merge(b->quantiles);
+}
+
+/**
+ * Write in @write the retained values of the sketch with their weights (same format of write_results). Return the median
+*/
+double write_sketch(FILE* write, stream_stat_t* s){
+
+    vector <stat_t> statistic;
+    s->quantiles.weighted(&statistic);
+    for(int i=0; i<(int) statistic.size(); ++i)  fprintf(write, "%.9f;%d\n", statistic[i].value, statistic[i].occurences);
+
+    return s->quantiles.quantile(0.5);
+}
+
+#endif  /*SKETCH_H*/
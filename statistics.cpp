@@ -0,0 +1,127 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the exact quantiles of the samples of a case scenario and their bootstrap confidence
+        intervals (CI):
+            - the quantile p is the order statistic of nearest rank ceil(p*n), found with nth_element; several
+              quantiles are selected in increasing order, each one on the part of the samples left by the previous
+            - percentile bootstrap: the samples are resampled with replacement B times and the quantiles of each
+              resample are computed; the CI bounds are the quantiles (1-c)/2 and (1+c)/2 of the B values.
+              The resamples are split among the threads; resample b draws from its own generator seeded by b, so
+              the CIs do not depend on the number of threads and the simulation random sequence is not touched.
+*/
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+const int STAT_N_QUANTILES= 4;
+const double STAT_QUANTILES[STAT_N_QUANTILES]= {0.5, 0.9, 0.99, 0.999};
+const char* STAT_QUANTILE_NAMES[STAT_N_QUANTILES]= {"p50", "p90", "p99", "p99.9"};
+
+
+/**
+ * splitmix64 generator: advance @state and return the next value
+*/
+unsigned long long splitmix64(unsigned long long* state){
+
+    unsigned long long z= (*state+= 0x9E3779B97F4A7C15ULL);
+    z= (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z= (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Index of the order statistic of nearest rank for the quantile @p of @n samples
+*/
+int quantile_index(double p, int n){
+
+    int i= (int) ceil(p * n) - 1;
+    return (i < 0)?  0 : (i >= n)?  n-1 : i;
+}
+
+/**
+ * Store in @out the quantiles @p (increasing) of the @n values @v -> @v is partially reordered
+*/
+void select_quantiles(float* v, int n, const double* p, int n_p, double* out){
+
+    int from= 0;
+    for(int q=0; q<n_p; ++q){
+        int i= quantile_index(p[q], n);
+        nth_element(v + from, v + i, v + n);
+        out[q]= v[i];
+        from= i;
+    }
+}
+
+/**
+ * Percentile bootstrap CIs at level @confidence of the quantiles @p of @samples, with @n_resamples resamples on @n_threads threads
+*/
+void bootstrap_ci(vector <float>* samples, const double* p, int n_p, int n_resamples, double confidence, int n_threads, unsigned long long seed,
+                  double* low, double* high){
+
+    int n= samples->size();
+    vector <double> boot(n_resamples * n_p);    //quantiles of each resample
+
+    auto worker= [&](int id){
+        vector <float> resample(n);
+        for(int b=id; b<n_resamples; b+=n_threads){
+            unsigned long long state= seed ^ ((unsigned long long) b << 32);
+            state= splitmix64(&state);  //independent stream of the resample
+            for(int i=0; i<n; ++i){
+                unsigned long long z= splitmix64(&state);
+                resample[i]= (*samples)[(unsigned long long) (((unsigned __int128) z * n) >> 64)];
+            }
+            select_quantiles(resample.data(), n, p, n_p, &boot[b * n_p]);
+        }
+    };
+
+    vector <thread> pool;
+    for(int i=0; i<n_threads; ++i)  pool.push_back(thread(worker, i));
+    for(int i=0; i<n_threads; ++i)  pool[i].join();
+
+    vector <float> column(n_resamples);
+    for(int q=0; q<n_p; ++q){
+        for(int b=0; b<n_resamples; ++b)    column[b]= boot[b * n_p + q];
+        double bounds[2]= {(1.0 - confidence) / 2, (1.0 + confidence) / 2};
+        double out[2];
+        select_quantiles(column.data(), n_resamples, bounds, 2, out);
+        low[q]= out[0];
+        high[q]= out[1];
+    }
+}
+
+/**
+ * Print the quantiles of @samples and, if @n_resamples > 0, their bootstrap CIs at level @confidence
+*/
+void print_quantiles(const char* label, vector <float>* samples, int n_resamples, double confidence, int n_threads, unsigned long long seed){
+
+    if(samples->empty())    return;
+
+    if(n_threads <= 0)  n_threads= thread::hardware_concurrency();
+    if(n_threads <= 0)  n_threads= 1;
+
+    vector <float> v(*samples);
+    double q[STAT_N_QUANTILES], low[STAT_N_QUANTILES], high[STAT_N_QUANTILES];
+    select_quantiles(v.data(), v.size(), STAT_QUANTILES, STAT_N_QUANTILES, q);
+    if(n_resamples > 0) bootstrap_ci(samples, STAT_QUANTILES, STAT_N_QUANTILES, n_resamples, confidence, n_threads, seed, low, high);
+
+    printf("%s (%d samples)\n", label, (int) samples->size());
+    for(int i=0; i<STAT_N_QUANTILES; ++i){
+        printf("  %-6s %.9f", STAT_QUANTILE_NAMES[i], q[i]);
+        if(n_resamples > 0) printf("  CI %.0f%%: [%.9f, %.9f]", confidence*100, low[i], high[i]);
+        printf("\n");
+    }
+}
+
+#endif  /*STATISTICS_H*/
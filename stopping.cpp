@@ -0,0 +1,151 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the sequential stopping of the simulation.
+        Each case scenario (bucket) keeps its samples and a distribution-free confidence interval (CI) on its median,
+        built from order statistics. A bucket stops collecting samples as soon as its CI is narrower than the
+        requested width, or when it reaches the maximum number of samples.
+        Samples can be weighted (importance sampling): the order statistics are then taken on the weighted
+        distribution, with the effective number of samples.
+*/
+
+#ifndef STOPPING_H
+#define STOPPING_H
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+const int STOP_MIN_SAMPLES= 30;   //minimum number of samples before checking the CI
+const int STOP_CHECK_INTERVAL= 16;    //the CI is recomputed every STOP_CHECK_INTERVAL new samples
+
+typedef struct{
+
+    vector <float> samples; //execution times of the rounds in the bucket
+    vector <float> weights; //importance weight of each sample -> 1 for the uniform placement
+    int converged;  //1 -> the bucket does not need more samples
+    double ci_low;  //lower bound of the median CI
+    double ci_high; //upper bound of the median CI
+
+}bucket_t;
+
+
+/**
+ * Return the z value such that P(|Z| <= z) = @confidence for a standard normal Z
+*/
+double normal_quantile(double confidence){
+
+    double target= (1.0 + confidence) / 2;
+    double low= 0.0, high= 10.0;
+
+    for(int i=0; i<100; ++i){   //bisection on the normal CDF
+        double mid= (low + high) / 2;
+        if(0.5 * erfc(-mid / sqrt(2.0)) < target)   low= mid;
+        else    high= mid;
+    }
+
+    return (low + high) / 2;
+}
+
+/**
+ * Return the @p quantile of the weighted distribution of @samples: the first sorted value whose cumulative weight reaches @p
+*/
+double weighted_quantile(vector <float>* samples, vector <float>* weights, double p){
+
+    int n= samples->size();
+    if(n == 0)  return 0.0;
+
+    vector <int> order(n);
+    for(int i=0; i<n; ++i)  order[i]= i;
+    sort(order.begin(), order.end(), [samples](int a, int b){return (*samples)[a] < (*samples)[b];});
+
+    double total= 0.0;
+    for(int i=0; i<n; ++i)  total+= (*weights)[i];
+
+    double cumulative= 0.0;
+    for(int i=0; i<n; ++i){
+        cumulative+= (*weights)[order[i]];
+        if(cumulative >= p*total)   return (*samples)[order[i]];
+    }
+
+    return (*samples)[order[n-1]];
+}
+
+/**
+ * Compute the distribution-free CI on the median of @samples at level @confidence.
+ * The bounds are the order statistics of rank n/2 -+ z*sqrt(n)/2 (normal approximation of the binomial).
+ * With non-uniform @weights, n is the effective number of samples and the ranks become fractions of the total weight.
+*/
+void median_ci(vector <float>* samples, vector <float>* weights, double confidence, double* low, double* high){
+
+    int n= samples->size();
+    double z= normal_quantile(confidence);
+
+    double sum_w= 0.0, sum_w2= 0.0;
+    int uniform= 1;
+    for(int i=0; i<n; ++i){
+        sum_w+= (*weights)[i];
+        sum_w2+= (*weights)[i] * (*weights)[i];
+        if((*weights)[i] != (*weights)[0])  uniform= 0;
+    }
+
+    if(!uniform){
+        double n_eff= sum_w*sum_w / sum_w2;
+        double l= floor((n_eff - z*sqrt(n_eff)) / 2);
+        double u= ceil((n_eff + z*sqrt(n_eff)) / 2) + 1;
+        *low= weighted_quantile(samples, weights, (l < 1)?  1.0/n_eff : l/n_eff);
+        *high= weighted_quantile(samples, weights, (u > n_eff)?  1.0 : u/n_eff);
+        return;
+    }
+
+    int l= (int) floor((n - z*sqrt(n)) / 2);  //rank of the lower bound (1-based)
+    int u= (int) ceil((n + z*sqrt(n)) / 2) + 1;  //rank of the upper bound (1-based)
+    if(l < 1)   l= 1;
+    if(u > n)   u= n;
+
+    vector <float> a(*samples);
+    nth_element(a.begin(), a.begin() + (l-1), a.end());
+    *low= a[l-1];
+    nth_element(a.begin(), a.begin() + (u-1), a.end());
+    *high= a[u-1];
+}
+
+void init_bucket(bucket_t* b){
+
+    b->samples.clear();
+    b->weights.clear();
+    b->converged= 0;
+    b->ci_low= 0.0;
+    b->ci_high= 0.0;
+}
+
+/**
+ * Add the sample @value, with importance weight @weight, to the bucket and update its convergence: the bucket converges when the CI on the median
+ * at level @confidence is narrower than @width, or when it holds @max_samples samples
+*/
+void add_sample(bucket_t* b, float value, float weight, double width, double confidence, int max_samples){
+
+    if(b->converged)    return;
+
+    b->samples.push_back(value);
+    b->weights.push_back(weight);
+    int n= b->samples.size();
+
+    if(n >= max_samples){
+        median_ci(&b->samples, &b->weights, confidence, &b->ci_low, &b->ci_high);
+        b->converged= 1;
+        return;
+    }
+
+    if(n >= STOP_MIN_SAMPLES && (n - STOP_MIN_SAMPLES) % STOP_CHECK_INTERVAL == 0){
+        median_ci(&b->samples, &b->weights, confidence, &b->ci_low, &b->ci_high);
+        if(b->ci_high - b->ci_low <= width) b->converged= 1;
+    }
+}
+
+#endif  /*STOPPING_H*/
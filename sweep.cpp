@@ -0,0 +1,335 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the parameter sweep: a grid of scenario parameters is expanded into cells, each cell is an
+        adaptive campaign and the cells are scheduled over a pool of threads.
+        The cells sharing the same topology parameters share the topology and the precomputed sampling tables.
+        All the cells use the same per-round seeds (common random numbers), so the differences between cells are
+        not hidden by different geometries.
+
+        Grid file: one parameter per line, '#' starts a comment
+            name = v1, v2, v3       list of values (Cartesian product)
+            name = a:b:step         values from a to b with the given step (Cartesian product)
+            name = a:b              range sampled with Latin hypercube (--lhs N)
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "config.cpp"
+#include "simulation.cpp"
+#include "sampler.cpp"
+#include "campaign.cpp"
+#include "measure.cpp"
+
+using namespace std;
+
+const int SWEEP_N_PARAMS= 9;
+const char* SWEEP_PARAMS[SWEEP_N_PARAMS]= {"attacker_range", "attacker_power", "bs_power", "layout_scale", "amf2_x", "amf2_y", "rounds", "version", "attacker"};
+const int SWEEP_TOPOLOGY_PARAMS= 6; //the first parameters define the topology
+
+typedef struct{
+
+    vector <double> values[SWEEP_N_PARAMS]; //values of the Cartesian product -> empty = default value
+    double low[SWEEP_N_PARAMS]; //range for the Latin hypercube
+    double high[SWEEP_N_PARAMS];
+    int is_range[SWEEP_N_PARAMS];   //1 -> the parameter is sampled with the Latin hypercube
+
+}sweep_spec_t;
+
+typedef struct{
+
+    double param[SWEEP_N_PARAMS];   //parameter tuple of the cell
+    campaign_t campaign;
+    double seconds; //execution time of the cell
+
+}sweep_cell_t;
+
+typedef struct{
+
+    topology_t topology;
+    sampler_t sampler;
+    once_flag sampler_ready;    //the sampling tables are computed once, by the first cell needing them
+
+}sweep_topology_t;
+
+
+/**
+ * Return the index of the parameter @name, -1 if unknown
+*/
+int sweep_param_index(const char* name){
+
+    for(int i=0; i<SWEEP_N_PARAMS; ++i) if(!strcmp(name, SWEEP_PARAMS[i])) return i;
+    return -1;
+}
+
+/**
+ * Read the grid file @file_name into @spec. Return 0 in case of error
+*/
+int parse_sweep(const char* file_name, sweep_spec_t* spec){
+
+    for(int i=0; i<SWEEP_N_PARAMS; ++i){
+        spec->values[i].clear();
+        spec->is_range[i]= 0;
+    }
+
+    FILE* f= fopen(file_name, "r");
+    if(f == NULL){
+        printf("Sweep - can not open %s\n", file_name);
+        return 0;
+    }
+
+    char line[1024];
+    while(fgets(line, sizeof(line), f) != NULL){
+
+        char* comment= strchr(line, '#');
+        if(comment != NULL) *comment= '\0';
+
+        char name[64];
+        char values[960];
+        if(sscanf(line, " %63[a-z_0-9] = %959[^\n]", name, values) != 2)   continue;
+
+        int p= sweep_param_index(name);
+        if(p == -1){
+            printf("Sweep - unknown parameter: %s\n", name);
+            fclose(f);
+            return 0;
+        }
+
+        double a, b, step;
+        int n_read= sscanf(values, "%lf:%lf:%lf", &a, &b, &step);
+
+        if(n_read == 3 && step > 0){    //a:b:step
+            for(double v= a; v <= b + 1e-9*fabs(b); v+= step)   spec->values[p].push_back(v);
+        }else if(n_read == 2){  //a:b
+            spec->is_range[p]= 1;
+            spec->low[p]= a;
+            spec->high[p]= b;
+        }else{  //v1, v2, ...
+            for(char* token= strtok(values, ","); token != NULL; token= strtok(NULL, ","))  spec->values[p].push_back(atof(token));
+        }
+    }
+
+    fclose(f);
+    return 1;
+}
+
+/**
+ * Default value of each parameter: the scenario of @cfg with the original topology
+*/
+void sweep_defaults(config_t* cfg, double* param){
+
+    param[0]= 150;  //attacker_range
+    param[1]= 100;  //attacker_power
+    param[2]= 100;  //bs_power
+    param[3]= 1.0;  //layout_scale
+    param[4]= -1;   //amf2_x -> -1 = position of the scaled layout
+    param[5]= -1;   //amf2_y
+    param[6]= cfg->n_rounds;
+    param[7]= cfg->handover_version;
+    param[8]= cfg->is_attacker;
+}
+
+/**
+ * Expand the grid into its cells: Latin hypercube with @lhs points over the ranges (if any) times the Cartesian
+ * product of the lists
+*/
+void build_cells(config_t* cfg, sweep_spec_t* spec, int lhs, vector <sweep_cell_t>* cells){
+
+    vector < vector <double> > points(1, vector <double>(SWEEP_N_PARAMS));
+    sweep_defaults(cfg, points[0].data());
+
+    //Latin hypercube: each range is divided in @lhs strata and each stratum is used exactly once
+    int n_ranges= 0;
+    for(int p=0; p<SWEEP_N_PARAMS; ++p) n_ranges+= spec->is_range[p];
+
+    if(n_ranges > 0 && lhs > 0){
+        vector <double> base= points[0];
+        points.assign(lhs, base);
+        unsigned int state= cfg->seed * 2654435761u + 1;
+
+        for(int p=0; p<SWEEP_N_PARAMS; ++p){
+            if(!spec->is_range[p])  continue;
+
+            vector <int> strata(lhs);
+            for(int i=0; i<lhs; ++i)    strata[i]= i;
+            for(int i=lhs-1; i>0; --i)  swap(strata[i], strata[probe_random(&state) % (i+1)]);
+
+            for(int i=0; i<lhs; ++i){
+                double u= (strata[i] + (probe_random(&state) % 10000) / 10000.0) / lhs;
+                points[i][p]= spec->low[p] + u * (spec->high[p] - spec->low[p]);
+            }
+        }
+    }
+
+    //Cartesian product with the lists
+    for(int p=0; p<SWEEP_N_PARAMS; ++p){
+        if(spec->values[p].empty()) continue;
+
+        vector < vector <double> > expanded;
+        for(int i=0; i<(int) points.size(); ++i){
+            for(int v=0; v<(int) spec->values[p].size(); ++v){
+                expanded.push_back(points[i]);
+                expanded.back()[p]= spec->values[p][v];
+            }
+        }
+        points.swap(expanded);
+    }
+
+    cells->resize(points.size());
+    for(int i=0; i<(int) points.size(); ++i){
+        for(int p=0; p<SWEEP_N_PARAMS; ++p){
+            (*cells)[i].param[p]= (p == 3)?  points[i][p] : round(points[i][p]);   //all integer parameters except the layout scale
+        }
+    }
+}
+
+/**
+ * Build the topology of the parameter tuple @param
+*/
+void sweep_topology(double* param, topology_t* t){
+
+    default_topology(t, param[3]);
+    t->attacker_range= (int) param[0];
+    t->attacker_power= (int) param[1];
+    t->bs_power= (int) param[2];
+    if(param[4] >= 0)   t->amf[1][1]= (int) param[4];
+    if(param[5] >= 0)   t->amf[1][2]= (int) param[5];
+    wired_delays(t);    //the AMF-2 may have moved
+}
+
+/**
+ * Run all the cells of the sweep on @n_threads threads and write the consolidated results
+*/
+int run_sweep(config_t* cfg){
+
+    sweep_spec_t spec;
+    if(!parse_sweep(cfg->sweep_file, &spec))    return 1;
+
+    for(int p=0; p<SWEEP_N_PARAMS; ++p){
+        if(spec.is_range[p] && cfg->lhs <= 0){  //the ranges would be silently replaced by the default values
+            printf("Sweep - the range of %s needs the number of Latin hypercube points (--lhs N)\n", SWEEP_PARAMS[p]);
+            return 1;
+        }
+    }
+
+    vector <sweep_cell_t> cells;
+    build_cells(cfg, &spec, cfg->lhs, &cells);
+
+    int n_threads= cfg->n_threads;
+    if(n_threads <= 0)  n_threads= thread::hardware_concurrency();
+    if(n_threads <= 0)  n_threads= 1;
+
+    printf("PARAMETER SWEEP: %d cells on %d threads\n\n", (int) cells.size(), n_threads);
+
+    //topologies (and sampling tables) shared among the cells -> key: topology parameters, handover version, attacker
+    map < vector <double>, sweep_topology_t* > topologies;
+    mutex topologies_lock;
+
+    for(int i=0; i<(int) cells.size(); ++i){
+        vector <double> key(cells[i].param, cells[i].param + SWEEP_TOPOLOGY_PARAMS);
+        key.push_back(cells[i].param[7]);
+        key.push_back(cells[i].param[8]);
+
+        if(topologies.find(key) == topologies.end()){
+            sweep_topology_t* t= new sweep_topology_t;
+            sweep_topology(cells[i].param, &t->topology);
+            if(cfg->pathloss != PATHLOSS_FREE || cfg->shadowing > 0){    //the gain table and the shadow maps depend on the layout
+                set_propagation(&t->topology, cfg->pathloss, cfg->pathloss_exp, cfg->carrier, cfg->shadowing, cfg->shadow_corr, cfg->seed);
+            }
+            topologies[key]= t;
+        }
+    }
+
+    atomic <int> next(0);
+    atomic <int> done(0);
+
+    auto worker= [&](int id){
+        pin_thread(id);
+
+        int i;
+        while((i= next++) < (int) cells.size()){
+            sweep_cell_t* cell= &cells[i];
+
+            config_t cell_cfg= *cfg;
+            cell_cfg.n_rounds= (int) cell->param[6];
+            cell_cfg.handover_version= (int) cell->param[7];
+            cell_cfg.is_attacker= (int) cell->param[8];
+
+            vector <double> key(cell->param, cell->param + SWEEP_TOPOLOGY_PARAMS);
+            key.push_back(cell->param[7]);
+            key.push_back(cell->param[8]);
+
+            sweep_topology_t* t;
+            {
+                lock_guard <mutex> guard(topologies_lock);
+                t= topologies[key];
+            }
+
+            if(cell_cfg.stratified) call_once(t->sampler_ready, init_sampler, &t->sampler, &t->topology, cell_cfg.handover_version, cell_cfg.is_attacker);
+
+            auto start= chrono::steady_clock::now();
+
+            init_campaign(&cell->campaign, cell_cfg.is_attacker);
+            while(campaign_round(&cell_cfg, &t->topology, &t->sampler, &cell->campaign)) {}
+
+            cell->seconds= chrono::duration <double>(chrono::steady_clock::now() - start).count();
+
+            int n= ++done;
+            if(n % 10 == 0 || n == (int) cells.size()) printf("Sweep - %d/%d cells completed\n", n, (int) cells.size());
+        }
+    };
+
+    vector <thread> pool;
+    for(int i=0; i<n_threads; ++i)  pool.push_back(thread(worker, i));
+    for(int i=0; i<n_threads; ++i)  pool[i].join();
+
+    for(auto& entry : topologies){
+        delete entry.second->topology.propagation;
+        delete entry.second;
+    }
+
+    //one consolidated result set: one line per cell, keyed by the parameter tuple
+    FILE* write= fopen(cfg->sweep_out, "w");
+    if(write == NULL){
+        printf("Sweep - can not open %s\n", cfg->sweep_out);
+        return 1;
+    }
+
+    for(int p=0; p<SWEEP_N_PARAMS; ++p) fprintf(write, "%s;", SWEEP_PARAMS[p]);
+    for(int k=0; k<3; ++k)  fprintf(write, "median%d;ci_low%d;ci_high%d;samples%d;", k+1, k+1, k+1, k+1);
+    fprintf(write, "drawn;simulated;seconds\n");
+
+    for(int i=0; i<(int) cells.size(); ++i){
+        campaign_t* c= &cells[i].campaign;
+
+        for(int p=0; p<SWEEP_N_PARAMS; ++p) fprintf(write, "%g;", cells[i].param[p]);
+        for(int k=0; k<3; ++k){
+            if(k < c->n_buckets)    fprintf(write, "%.9f;%.9f;%.9f;%d;", campaign_median(c, k), c->bucket[k].ci_low, c->bucket[k].ci_high, (int) c->bucket[k].samples.size());
+            else    fprintf(write, ";;;0;");
+        }
+        fprintf(write, "%lld;%lld;%.3f\n", c->drawn, c->simulated, cells[i].seconds);
+    }
+
+    fclose(write);
+
+    printf("\nResults written in %s\n", cfg->sweep_out);
+    puts("CORRECTLY TERMINATED");
+    return 0;
+}
+
+#endif  /*SWEEP_H*/
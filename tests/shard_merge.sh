@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+#   @Author/Owner: Alessandro Lotto
+#   @Last update: 18/10/2026
+#   @Note: This code has been build completely from scratch
+#
+#   @Description:
+#       Check that the merge of a sharded campaign gives the same samples of the single process campaign, sample for
+#       sample. The handling times come from a cost profile written by bench, so both runs are deterministic.
+#       Run from the root of the repository: sh tests/shard_merge.sh
+
+set -e
+
+SRC=$(pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+g++ -std=gnu++20 -O2 "$SRC/main.cpp" -o "$WORK/baron" -lpthread
+g++ -std=gnu++20 -O2 "$SRC/bench.cpp" -o "$WORK/bench" -lpthread
+"$WORK/bench" --rounds 20 --repeat 3 --out "$WORK/cost.json" > /dev/null
+
+status=0
+for variant in "--patched --attacker" "--standard --attacker" "--patched --no-attacker" "--standard --no-attacker"; do
+    for rounds in 30 300; do
+        rm -rf "$WORK/single" "$WORK/shards"
+        mkdir "$WORK/single" "$WORK/shards"
+
+        (cd "$WORK/single" && "$WORK/baron" $variant --rounds $rounds --cost-model "$WORK/cost.json" > /dev/null)
+        (cd "$WORK/shards" &&
+            for i in 0 1 2; do
+                "$WORK/baron" $variant --rounds $rounds --cost-model "$WORK/cost.json" --shard $i/3 --total-rounds 100000 > /dev/null
+            done &&
+            "$WORK/baron" merge partial_0.bin partial_1.bin partial_2.bin > /dev/null)
+
+        result="ok  "
+        for f in "$WORK"/single/results*.xls; do
+            if ! cmp -s "$f" "$WORK/shards/$(basename "$f")"; then
+                echo "     $(basename "$f") differs"
+                result="FAIL"
+                status=1
+            fi
+        done
+        echo "$result $variant --rounds $rounds"
+    done
+done
+
+exit $status
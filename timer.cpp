@@ -0,0 +1,139 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the timer used to measure the message handling times.
+        Two clocks are available, selected at runtime:
+            - steady_clock: portable (default if the TSC can not be used)
+            - TSC: rdtsc/rdtscp with lfence serialization, calibrated against steady_clock. Available only on x86
+              with invariant TSC.
+        For both clocks the cost of an empty start/stop pair is measured once and subtracted from every measurement,
+        so that short handlers (e.g. BS forwarding) are not dominated by the cost of reading the clock.
+*/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdio.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define TIMER_HAS_TSC 1
+#else
+#define TIMER_HAS_TSC 0
+#endif
+
+using namespace std;
+
+const int TIMER_STEADY= 0;
+const int TIMER_TSC= 1;
+const int TIMER_OVERHEAD_SAMPLES= 10000;    //start/stop pairs for the measurement of the timer overhead
+
+int timer_mode= TIMER_STEADY;
+double timer_ns_per_tick= 1.0;  //steady_clock ticks are nanoseconds
+double timer_overhead= 0.0; //ticks of an empty start/stop pair
+
+
+/**
+ * Read the clock at the start of a measurement: the fences keep the measured code out of the reading
+*/
+inline unsigned long long timer_start(){
+
+#if TIMER_HAS_TSC
+    if(timer_mode == TIMER_TSC){
+        _mm_lfence();
+        unsigned long long t= __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+#endif
+    return chrono::duration_cast <chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Read the clock at the end of a measurement: rdtscp waits for the previous instructions to complete
+*/
+inline unsigned long long timer_stop(){
+
+#if TIMER_HAS_TSC
+    if(timer_mode == TIMER_TSC){
+        unsigned int aux;
+        unsigned long long t= __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+    }
+#endif
+    return chrono::duration_cast <chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Return the time (s) between @start and @stop without the timer overhead
+*/
+inline double timer_seconds(unsigned long long start, unsigned long long stop){
+
+    double ticks= (double) (stop - start) - timer_overhead;
+    if(ticks < 0)   ticks= 0;
+    return ticks * timer_ns_per_tick * 1e-9;
+}
+
+/**
+ * Return 1 if the CPU has an invariant TSC (constant rate in all the power states)
+*/
+int tsc_invariant(){
+
+#if TIMER_HAS_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)  return 0;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx >> 8) & 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Select the clock (TIMER_STEADY or TIMER_TSC), calibrate it and measure its overhead, printed when the TSC is requested.
+ * Fall back to steady_clock if the TSC is not usable. Return the clock in use.
+*/
+int timer_init(int mode){
+
+    timer_mode= TIMER_STEADY;
+    timer_ns_per_tick= 1.0;
+
+    if(mode == TIMER_TSC){
+        if(!tsc_invariant()){
+            printf("Timer - no invariant TSC: steady_clock is used\n");
+        }else{
+            //ticks per nanosecond over a 50ms busy wait
+            timer_mode= TIMER_TSC;
+            auto t0= chrono::steady_clock::now();
+            unsigned long long c0= timer_start();
+            while(chrono::steady_clock::now() - t0 < chrono::milliseconds(50)) {}
+            unsigned long long c1= timer_stop();
+            double ns= chrono::duration_cast <chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+
+            timer_ns_per_tick= ns / (c1 - c0);
+        }
+    }
+
+    //overhead: minimum over many empty measurements
+    timer_overhead= 0.0;
+    unsigned long long best= ~0ULL;
+    for(int i=0; i<TIMER_OVERHEAD_SAMPLES; ++i){
+        unsigned long long start= timer_start();
+        unsigned long long stop= timer_stop();
+        if(stop - start < best) best= stop - start;
+    }
+    timer_overhead= best;
+
+    if(mode == TIMER_TSC){  //the default run keeps the output of the original simulation
+        printf("Timer: %s, %.3f ns per tick, overhead %.1f ns\n\n", (timer_mode == TIMER_TSC)?  "TSC" : "steady_clock", timer_ns_per_tick, timer_overhead * timer_ns_per_tick);
+    }
+    return timer_mode;
+}
+
+#endif  /*TIMER_H*/
@@ -0,0 +1,242 @@
+/*
+    @Author/Owner: Alessandro Lotto
+    @Last update: 18/10/2026
+    @Note: This code has been build completely from scratch
+
+    @Description:
+        This file implements the optional binary trace of the simulated rounds.
+        For each round it records the round identity (seed and index), the state of the random generator at the start
+        of the simulation, the geometry and the sequence of handled messages (from, to, message type, type of
+        transmission, handling time), so that any round can be re-executed alone (see replay.cpp).
+        The records are serialized in a per-thread buffer, which is appended to the trace file only when full:
+        the simulation threads never contend on the file for single rounds. The buffer is also written at every
+        checkpoint, so that with --resume the trace is reopened, cut after the checkpoint round and continued.
+
+        Trace format (native endianness):
+            "BARONTRC" | version (uint32)
+            for each round: round (int64) | seed (uint32) | rng state (uint64) | handover version (uint8) | attacker (uint8) |
+                            handover completed (int8) | n_hops (uint16) | ue_x, ue_y, att_x, att_y, fake_id (int32) |
+                            time (double) | n_hops x {from (uint8), to (uint8), message type (uint8),
+                            type of transmission (uint8), handling time (float)}
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <mutex>
+
+#include "rng.cpp"
+#include "message.cpp"
+#include "checkpoint.cpp"
+
+using namespace std;
+
+const char TRACE_MAGIC[]= "BARONTRC";
+const unsigned int TRACE_VERSION= 1;
+const int TRACE_BUFFER_SIZE= 1 << 20;   //size (bytes) at which a per-thread buffer is appended to the file
+
+const int TRACE_N_MSG_TYPES= MSG_N_TYPES;
+const char** TRACE_MSG_TYPES= MSG_NAMES;    //index = msg_type_t
+
+typedef struct{
+
+    unsigned char from; //index in the message channel of the entity handling the message
+    unsigned char to;   //index in the message channel of the receiver of the answer
+    unsigned char msg_type; //index in TRACE_MSG_TYPES of the handled message
+    unsigned char type_transmission;    //type of transmission of the answer (see simulate_round)
+    float handling_time;    //time (s) spent in handle_message
+
+}trace_hop_t;
+
+typedef struct{
+
+    long long round;    //index of the round in the campaign
+    unsigned int seed;  //seed of the campaign
+    unsigned long long rng_state;   //state of the random generator at the start of the simulation of the round
+    int handover_version;
+    int is_attacker;
+    int handover_completed;
+    int geometry[5];    //ue_x, ue_y, att_x, att_y, fake_id
+    double time;    //overall handover execution time
+    vector <trace_hop_t> hops;
+
+}trace_round_t;
+
+class trace_buffer{
+    public:
+        vector <char> data; //serialized rounds not yet written
+        trace_round_t current;  //round being simulated by the thread
+
+        ~trace_buffer();    //append the remaining rounds at the exit of the thread
+};
+
+FILE* trace_file= NULL; //NULL -> tracing disabled
+mutex trace_lock;
+thread_local trace_buffer trace_tls;
+
+
+/**
+ * Return the name of the message type of index @id
+*/
+const char* trace_msg_name(int id){
+
+    return (id < TRACE_N_MSG_TYPES)?  TRACE_MSG_TYPES[id] : "Unknown";
+}
+
+/**
+ * Append the per-thread buffer @data to the trace file
+*/
+void trace_flush(vector <char>* data){
+
+    if(data->empty())   return;
+
+    lock_guard <mutex> guard(trace_lock);
+    if(trace_file != NULL)  fwrite(data->data(), 1, data->size(), trace_file);
+    data->clear();
+}
+
+trace_buffer::~trace_buffer(){
+
+    trace_flush(&data);
+}
+
+/**
+ * Close the trace file -> registered with atexit(), after the exit of the threads flushing their buffers
+*/
+void trace_close(){
+
+    lock_guard <mutex> guard(trace_lock);
+    if(trace_file != NULL)  fclose(trace_file);
+    trace_file= NULL;
+}
+
+/**
+ * Start the record of a round: to be called before the simulation draws any random number
+*/
+void trace_begin(int handover_version, int is_attacker, int geometry[5]){
+
+    trace_round_t* t= &trace_tls.current;
+    t->round= rng_round;
+    t->seed= rng_seed;
+    t->rng_state= rng_state;
+    t->handover_version= handover_version;
+    t->is_attacker= is_attacker;
+    for(int i=0; i<5; ++i)  t->geometry[i]= geometry[i];
+    t->hops.clear();
+}
+
+void trace_hop(int from, int to, int msg_type, int type_transmission, double handling_time){
+
+    trace_hop_t h= {(unsigned char) from, (unsigned char) to, (unsigned char) msg_type, (unsigned char) type_transmission, (float) handling_time};
+    trace_tls.current.hops.push_back(h);
+}
+
+/**
+ * Complete the record of the round and serialize it in the per-thread buffer
+*/
+void trace_end(int handover_completed, double time){
+
+    trace_round_t* t= &trace_tls.current;
+    vector <char>* b= &trace_tls.data;
+
+    unsigned char variant[3]= {(unsigned char) t->handover_version, (unsigned char) t->is_attacker, (unsigned char) (signed char) handover_completed};
+    unsigned short n_hops= t->hops.size();
+
+    put_bytes(b, &t->round, sizeof(t->round));
+    put_bytes(b, &t->seed, sizeof(t->seed));
+    put_bytes(b, &t->rng_state, sizeof(t->rng_state));
+    put_bytes(b, variant, 3);
+    put_bytes(b, &n_hops, sizeof(n_hops));
+    put_bytes(b, t->geometry, sizeof(t->geometry));
+    put_bytes(b, &time, sizeof(time));
+    for(int i=0; i<n_hops; ++i){
+        put_bytes(b, &t->hops[i].from, 4);
+        put_bytes(b, &t->hops[i].handling_time, sizeof(float));
+    }
+
+    if(b->size() >= TRACE_BUFFER_SIZE)  trace_flush(b);
+}
+
+/**
+ * Read the next round of the trace @f into @t. Return 0 at the end of the trace
+*/
+int trace_read(FILE* f, trace_round_t* t){
+
+    unsigned char variant[3];
+    unsigned short n_hops;
+
+    int ok= get_bytes(f, &t->round, sizeof(t->round)) && get_bytes(f, &t->seed, sizeof(t->seed)) && get_bytes(f, &t->rng_state, sizeof(t->rng_state));
+    ok= ok && get_bytes(f, variant, 3) && get_bytes(f, &n_hops, sizeof(n_hops)) && get_bytes(f, t->geometry, sizeof(t->geometry)) && get_bytes(f, &t->time, sizeof(t->time));
+    if(!ok) return 0;
+
+    t->handover_version= variant[0];
+    t->is_attacker= variant[1];
+    t->handover_completed= (signed char) variant[2];
+
+    t->hops.resize(n_hops);
+    for(int i=0; ok && i<n_hops; ++i)   ok= get_bytes(f, &t->hops[i].from, 4) && get_bytes(f, &t->hops[i].handling_time, sizeof(float));
+
+    return ok;
+}
+
+/**
+ * Open the trace file @file_name: from now on all the simulated rounds are recorded. With @resume_round >= 0 (--resume)
+ * the rounds recorded up to that round are kept and the new ones follow them. Return 0 in case of error
+*/
+int trace_open(const char* file_name, long long resume_round){
+
+    trace_file= (resume_round >= 0)?  fopen(file_name, "r+b") : NULL;
+    if(trace_file == NULL){ //new trace
+        trace_file= fopen(file_name, "wb");
+        if(trace_file == NULL){
+            printf("Trace - can not open %s\n", file_name);
+            return 0;
+        }
+
+        fwrite(TRACE_MAGIC, 1, 8, trace_file);
+        fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1, trace_file);
+        return 1;
+    }
+
+    char magic[8];
+    unsigned int version;
+    if(!get_bytes(trace_file, magic, 8) || memcmp(magic, TRACE_MAGIC, 8) || !get_bytes(trace_file, &version, sizeof(version)) || version != TRACE_VERSION){
+        printf("Trace - %s is not a valid trace\n", file_name);
+        fclose(trace_file);
+        trace_file= NULL;
+        return 0;
+    }
+
+    //the rounds are in order (the campaigns with a checkpoint run on one thread): cut the trace after the last round
+    //of the checkpoint
+    trace_round_t t;
+    long long end= ftell(trace_file);
+    while(trace_read(trace_file, &t) && t.round <= resume_round)   end= ftell(trace_file);
+
+    fflush(trace_file);
+    if(ftruncate(fileno(trace_file), end) != 0 || fseek(trace_file, end, SEEK_SET) != 0){
+        printf("Trace - can not truncate %s\n", file_name);
+        fclose(trace_file);
+        trace_file= NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Write the rounds recorded so far by the calling thread -> called at every checkpoint
+*/
+void trace_sync(){
+
+    if(trace_file == NULL)  return;
+
+    trace_flush(&trace_tls.data);
+    lock_guard <mutex> guard(trace_lock);
+    fflush(trace_file);
+}
+
+#endif  /*TRACE_H*/
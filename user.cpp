@@ -14,17 +14,12 @@
 #include <string.h>
 #include <stdlib.h>
 
-#include "message.cpp"
+#include "channel.cpp"
 #include "./crypto.cpp"
+#include "./rng.cpp"
 
 using namespace std;
 
-const char MR[]= "Measurement Report";
-const char HC[]= "Handover Command";
-const char RO[]= "RACH OK";
-const char REC_OK[]= "Reconnection Recovery OK";
-const char REC_REJ[]= "Reconnection Recovery Rejected";
-
 unsigned char AMF_key[]= "abcdefghilmnopqr";
 unsigned char sBS_key[]= "djv0ncjodnon0nnn";
 
@@ -67,8 +62,12 @@ class user{
 
         int select_best_bs(double channel[][2], int n_bs);    //returns the ID of the base station for which receive the best signal
         int select_best_bs(double channel[][2], int n_bs, int exclude);    //returns the ID of the base station for which receive the best signal excluding the given ID
-        int transmit_message(message* msg_channel[], const char* message_type); //transmit the message
-        void handle_message(message* msg_channel[], message* msg, double channel[][2], int* handover_completed, int* type_transmission);
+        int transmit_message(message_channel* msg_channel, msg_type_t message_type); //transmit the message
+        void handle_message(message_channel* msg_channel, message* msg, double channel[][2], int* handover_completed, int* type_transmission);
+
+        //versions specialized at compile time on the handover variant -> the standard one does not contain the BARON code
+        template <bool Patched> int transmit_message(message_channel* msg_channel, msg_type_t message_type);
+        template <bool Patched> void handle_message(message_channel* msg_channel, message* msg, double channel[][2], int* handover_completed, int* type_transmission);
 
 };
 
@@ -123,20 +122,26 @@ int user::select_best_bs(double channel[][2], int n_bs, int exclude){
 }
 
 
-int user::transmit_message(message* msg_channel[], const char* message_type){
+int user::transmit_message(message_channel* msg_channel, msg_type_t message_type){
+
+    return (is_patched)?  transmit_message<true>(msg_channel, message_type) : transmit_message<false>(msg_channel, message_type);
+}
+
+template <bool Patched>
+int user::transmit_message(message_channel* msg_channel, msg_type_t message_type){
 
     //printf("UE - Measurement Report Transmission\n");
 
-    if(!strcmp(message_type, MR)){  //Measurement Report case
+    if(message_type == MSG_MEASUREMENT_REPORT){  //Measurement Report case
 
         int content[2];
         content[0]= ue_id;
         content[1]= target; //ID of tBS
 
-        message* msg;
+        message msg;
 
-        if(is_patched){ //if patched version
-            auth_token= rand(); //generate the random value for the authentication token
+        if constexpr(Patched){ //if patched version
+            auth_token= sim_rand(); //generate the random value for the authentication token
 
             //conversion into a string
             unsigned char temp[4];
@@ -144,32 +149,39 @@ int user::transmit_message(message* msg_channel[], const char* message_type){
             for(int i=0; i<4; ++i)  temp[i]= *(temp1 + i);
 
             unsigned char* temp2= AES128_encryption(temp, 4, AMF_key); //encryption
-            msg= new message(message_type, content, 2, temp2);
+            msg= message(message_type, content, 2, temp2);
 
             free(temp2);    //free the allocated space
 
-        }else   msg= new message(message_type, content, 2+1*is_patched);
+        }else   msg= message(message_type, content, 2);
 
-        msg_channel[s_index]= msg;
+        msg_channel->post(s_index, msg);
         return 1;
     }    
     return 0;   //in case the message has not correctly sent
 }
 
 
-void user::handle_message(message* msg_channel[], message* msg, double channel[][2], int* handover_completed, int* type_transmission){
+void user::handle_message(message_channel* msg_channel, message* msg, double channel[][2], int* handover_completed, int* type_transmission){
+
+    if(is_patched)  handle_message<true>(msg_channel, msg, channel, handover_completed, type_transmission);
+    else    handle_message<false>(msg_channel, msg, channel, handover_completed, type_transmission);
+}
+
+template <bool Patched>
+void user::handle_message(message_channel* msg_channel, message* msg, double channel[][2], int* handover_completed, int* type_transmission){
     
-    char* msg_type= msg->get_type();
+    msg_type_t msg_type= msg->get_type();
     //printf("UE - Message received: %s\n", msg_type);
 
-    if(!strcmp(msg_type, HC)){   //Handover command
+    if(msg_type == MSG_HANDOVER_COMMAND){   //Handover command
 
-        if(is_patched){ //if patched versione then need to save the reconnection token
+        if constexpr(Patched){ //if patched versione then need to save the reconnection token
 
             //RECONNECTION TOKEN EXTRACTION
-            unsigned char* enc_token= msg->get_token();    //extract the encrypted authentication token
+            token_t enc_token= msg->get_token();    //extract the encrypted authentication token
             for(int i=0; i<4; ++i)  rec_token_enc[i]= enc_token[12+i];  //save the 4 least-significant bytes of the encrypted value in case for reconnection with sBS
-            unsigned char* dec_token= AES128_decryption(enc_token, AMF_key); //decryption            
+            unsigned char* dec_token= AES128_decryption(enc_token.data(), AMF_key); //decryption            
 
             rec_token= 0;
             unsigned char* temp= (unsigned char*) &rec_token;
@@ -177,27 +189,25 @@ void user::handle_message(message* msg_channel[], message* msg, double channel[]
 
             //printf("UE - reconnection token extracted: %d\n", rec_token);
 
-            free(enc_token);    //free the allocated space
             free(dec_token);    //free the allocated space
         }
 
         int content[]= {};   //empty content
-        message* new_msg= new message("RACH procedure", content, 0); //build up the corresponding message
-        msg_channel[t_index]= new_msg;    //transmit the message
+        message new_msg(MSG_RACH, content, 0); //build up the corresponding message
+        msg_channel->post(t_index, new_msg);    //transmit the message
 
-        delete msg; //destroy the received message
-        msg_channel[0]= NULL;   //index 0 because is the UE
+        msg_channel->clear(0);   //index 0 because is the UE
 
         *type_transmission= 1;
 
         return;
     }
 
-    if(!strcmp(msg_type, RO)){   //RACH OK
-        if(is_patched){
+    if(msg_type == MSG_RACH_OK){   //RACH OK
+        if constexpr(Patched){
 
-            unsigned char* enc_token= msg->get_token(); //extract the encrypted token
-            unsigned char* dec_token= AES128_decryption(enc_token, AMF_key); //decryption
+            token_t enc_token= msg->get_token(); //extract the encrypted token
+            unsigned char* dec_token= AES128_decryption(enc_token.data(), AMF_key); //decryption
 
             unsigned int temp= 0;
             unsigned char* temp1= (unsigned char*) &temp;
@@ -232,11 +242,10 @@ void user::handle_message(message* msg_channel[], message* msg, double channel[]
                     for(int i=0; i<4; ++i)  temp2[i]= *(temp3 + i);
 
                     unsigned char* temp4= AES128_encryption(temp2, 4, AMF_key); //encryption
-                    message* new_msg= new message("Reconnection Recovery", content, 2, temp4);
+                    message new_msg(MSG_RECONNECTION, content, 2, temp4);
 
-                    msg_channel[t_index]= new_msg;    //transmit the message
-                    delete msg; //destroy the received message
-                    msg_channel[0]= NULL;   //index 0 because is the UE
+                    msg_channel->post(t_index, new_msg);    //transmit the message
+                    msg_channel->clear(0);   //index 0 because is the UE
                     *type_transmission= 1;
 
                     free(temp4);    //free the allocated space
@@ -247,21 +256,19 @@ void user::handle_message(message* msg_channel[], message* msg, double channel[]
                     for(int i=0; i<4; ++i)  rec_token_enc[i]^= sBS_key[i]; //need to transform the encrypted reconnection token -> we implement a simple XOR with the key of sBS
 
                     int content[]= {ue_id};  //empty content
-                    message* new_msg= new message("Reconnection Recovery", content, 1, rec_token_enc);  //generate the new message
+                    message new_msg(MSG_RECONNECTION, content, 1, rec_token_enc, 4);  //generate the new message
 
-                    msg_channel[s_index]= new_msg;    //transmit the message
-                    delete msg; //destroy the received message
-                    msg_channel[0]= NULL;   //index 0 because is the UE
+                    msg_channel->post(s_index, new_msg);    //transmit the message
+                    msg_channel->clear(0);   //index 0 because is the UE
                     *type_transmission= 1;
                 }               
             }
             
-            free(enc_token);
             free(dec_token);
 
             return;
 
-        } //#if(is_patched)
+        } //#if(Patched)
 
         *type_transmission= 0;  //not doing anything -> no message transmitted so no time to compute needed
         *handover_completed= 1;
@@ -270,56 +277,59 @@ void user::handle_message(message* msg_channel[], message* msg, double channel[]
 
     } //#if(RACH OK)
 
-    if(!strcmp(msg_type, REC_OK)){  //Reconnection Recovery OK
+    if constexpr(Patched){  //the reconnection recovery exists only in the patched version
 
-        if(target == connected){    //if reconnection with sBS
-            unsigned char* temp= msg->get_token();  //extraction of the received token      
+        if(msg_type == MSG_RECONNECTION_OK){  //Reconnection Recovery OK
 
-            int temp1= 0;
-            unsigned char* temp2= (unsigned char*) &temp1;
-            for(int i=0; i<4; ++i)  *(temp2+i)= temp[i];   //move the received reconnection token into an int container
+            if(target == connected){    //if reconnection with sBS
+                const token_t& temp= msg->get_token();  //received token
 
-            //printf("UE - Reconnection token extracted: %u\n", temp1);
+                int temp1= 0;
+                unsigned char* temp2= (unsigned char*) &temp1;
+                for(int i=0; i<4; ++i)  *(temp2+i)= temp[i];   //move the received reconnection token into an int container
 
-            free(temp); //free the alloated space
+                //printf("UE - Reconnection token extracted: %u\n", temp1);
 
-            //now need to transform the encrypted reconnection token into an int value
-            rec_token= 0;      
-            temp2= (unsigned char*) &rec_token;
-            for(int i=0; i<4; ++i)  *(temp2+i)= rec_token_enc[i];
+                //now need to transform the encrypted reconnection token into an int value
+                rec_token= 0;      
+                temp2= (unsigned char*) &rec_token;
+                for(int i=0; i<4; ++i)  *(temp2+i)= rec_token_enc[i];
 
-            if(rec_token+1 == temp1)    *handover_completed= 2;    //verification of the token
-            else    *handover_completed= -2;
+                if(rec_token+1 == temp1)    *handover_completed= 2;    //verification of the token
+                else    *handover_completed= -2;
 
-            *type_transmission= 0;  //not doing anything -> no message transmitted so no time to compute needed
+                *type_transmission= 0;  //not doing anything -> no message transmitted so no time to compute needed
 
-            return;
+                return;
         
-        }else{  //if reconnection with other BS
-            unsigned char* enc_token= msg->get_token(); //extract the encrypted token
-            unsigned char* dec_token= AES128_decryption(enc_token, AMF_key); //decryption
+            }else{  //if reconnection with other BS
+                token_t enc_token= msg->get_token(); //extract the encrypted token
+                unsigned char* dec_token= AES128_decryption(enc_token.data(), AMF_key); //decryption
 
-            unsigned int temp= 0;
-            unsigned char* temp1= (unsigned char*) &temp;
-            for(int i=0; i<4; ++i)  *(temp1 + i)= dec_token[12+i];  //move the decrypted value into an int container
+                unsigned int temp= 0;
+                unsigned char* temp1= (unsigned char*) &temp;
+                for(int i=0; i<4; ++i)  *(temp1 + i)= dec_token[12+i];  //move the decrypted value into an int container
 
-            //printf("UE - token obtained: %u, token expected: %u\n", temp, rec_token+1);
+                //printf("UE - token obtained: %u, token expected: %u\n", temp, rec_token+1);
 
-            if(rec_token+1 == temp) *handover_completed= 2;
-            else    *handover_completed= -2;
+                free(dec_token);
 
-            *type_transmission= 0;
-            return;
+                if(rec_token+1 == temp) *handover_completed= 2;
+                else    *handover_completed= -2;
+
+                *type_transmission= 0;
+                return;
+            }
         }
-    }
 
-    if(!strcmp(msg_type, REC_REJ)){  //Reconnection Recovery Rejected
+        if(msg_type == MSG_RECONNECTION_REJECTED){  //Reconnection Recovery Rejected
 
-        *type_transmission= 0;  //not doing anything -> no message transmitted so no time to compute needed
-        *handover_completed= -1;
-        return;
+            *type_transmission= 0;  //not doing anything -> no message transmitted so no time to compute needed
+            *handover_completed= -1;
+            return;
 
-    }
+        }
+    } //#if(Patched)
 }
 
 //--------------------------------